@@ -0,0 +1,750 @@
+#include "BatchRunner.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <streambuf>
+#include <chrono>
+#include <thread>
+#include <deque>
+#include <memory>
+#include <cstdio>
+#include <cstdint>
+#include <stdexcept>
+#include <iomanip>
+#include <limits>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <io.h>
+#include <fcntl.h>
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <cerrno>
+#include <climits>
+#ifdef __APPLE__
+#include <mach-o/dyld.h>
+#endif
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @class PayloadBuffer
+ * @brief Буфер потока поверх общей памяти: результат пишется сразу в неё без копий
+ */
+class PayloadBuffer : public std::streambuf {
+public:
+    PayloadBuffer(char* data, size_t capacity) { setp(data, data + capacity); }
+    size_t size() const { return static_cast<size_t>(pptr() - pbase()); }
+};
+
+/**
+ * @brief Первая строка текста без переводов строк, для передачи в однострочном ответе
+ */
+std::string firstLine(const std::string& text) {
+    std::string line = text.substr(0, text.find('\n'));
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    return line.empty() ? "build failed" : line;
+}
+
+/**
+ * @brief Цикл рабочего процесса: читает задания из канала, строит вал и кладёт результат в общую память
+ *
+ * Ответ на задание - одна строка: "<индекс> ok <размер>" или "<индекс> error <сообщение>".
+ */
+int workerLoop(FILE* jobs, FILE* replies, char* payload, size_t capacity,
+               ExportFormat format, FeaturePipeline pipeline, CheckLevel checkLevel, bool compaction) {
+    // Журнал построения родителю не нужен, ошибки передаются в ответе
+    std::cout.rdbuf(nullptr);
+    ShaftAppCore core;
+    core.setFeaturePipeline(pipeline);
+    core.setCheckLevel(checkLevel);
+    core.setCompaction(compaction);
+
+    char line[512];
+    while (std::fgets(line, sizeof(line), jobs)) {
+        size_t jobIndex = 0;
+        double totalLength = 0.0;
+        double cylinder4Diameter = 0.0;
+        double cylinder9Diameter = 0.0;
+        std::istringstream request(line);
+        std::ostringstream reply;
+        if (!(request >> jobIndex >> totalLength >> cylinder4Diameter >> cylinder9Diameter)) {
+            reply << jobIndex << " error malformed job\n";
+        } else {
+            std::ostringstream errors;
+            std::streambuf* previousErrors = std::cerr.rdbuf(errors.rdbuf());
+            // Рабочий процесс живёт долго, история правок ему не нужна
+            core.clearHistory();
+            core.setTotalLength(totalLength);
+            core.setSegmentDiameter(3, cylinder4Diameter);
+            core.setSegmentDiameter(9, cylinder9Diameter);
+            PayloadBuffer buffer(payload, capacity);
+            std::ostream output(&buffer);
+            int result = core.run(output, format);
+            std::cerr.rdbuf(previousErrors);
+
+            if (result == 0) {
+                reply << jobIndex << " ok " << buffer.size() << "\n";
+            } else if (buffer.size() == capacity) {
+                reply << jobIndex << " error payload exceeds shared memory capacity\n";
+            } else {
+                reply << jobIndex << " error " << firstLine(errors.str()) << "\n";
+            }
+        }
+        std::fputs(reply.str().c_str(), replies);
+        std::fflush(replies);
+    }
+    return 0;
+}
+
+/**
+ * @class WorkerProcess
+ * @brief Рабочий процесс пула: каналы заданий и ответов и общая память для результата
+ */
+class WorkerProcess {
+public:
+    enum class State { Pending, Ready, Died };
+
+    explicit WorkerProcess(const BatchOptions& options)
+        : m_options(options), m_capacity(options.payloadCapacityMb * 1024 * 1024) {}
+
+    ~WorkerProcess() {
+        stop();
+        releasePayload();
+    }
+
+    WorkerProcess(const WorkerProcess&) = delete;
+    WorkerProcess& operator=(const WorkerProcess&) = delete;
+
+    bool start();
+    void stop();
+    bool send(const std::string& line);
+    State poll(std::string& reply);
+
+    /**
+     * @brief Резидентная память процесса, МБ; 0, если система её не сообщает
+     *
+     * В Windows ограничение памяти задаётся объектом задания и здесь не проверяется.
+     */
+    size_t residentMb() const;
+
+    const char* payload() const { return m_payload; }
+    size_t capacity() const { return m_capacity; }
+
+private:
+    bool takeLine(std::string& reply) {
+        size_t end = m_pending.find('\n');
+        if (end == std::string::npos) return false;
+        reply = m_pending.substr(0, end);
+        m_pending.erase(0, end + 1);
+        return true;
+    }
+
+    void releasePayload();
+
+    BatchOptions m_options;
+    size_t m_capacity;
+    char* m_payload = nullptr;
+    std::string m_pending;
+#ifdef _WIN32
+    HANDLE m_mapping = nullptr;
+    HANDLE m_process = nullptr;
+    HANDLE m_job = nullptr;
+    HANDLE m_jobWrite = nullptr;
+    HANDLE m_replyRead = nullptr;
+#else
+    pid_t m_pid = -1;
+    int m_jobFd = -1;
+    int m_replyFd = -1;
+    int m_payloadFd = -1;
+#endif
+};
+
+const char* formatName(ExportFormat format) {
+    return format == ExportFormat::BRep ? "brep" : "step";
+}
+
+const char* pipelineName(FeaturePipeline pipeline) {
+    return pipeline == FeaturePipeline::SegmentLocal ? "local" : "global";
+}
+
+#ifdef _WIN32
+
+bool WorkerProcess::start() {
+    SECURITY_ATTRIBUTES inheritable = {sizeof(SECURITY_ATTRIBUTES), nullptr, TRUE};
+    if (!m_mapping) {
+        // Отображение не наследуется: его получает только свой рабочий через список дескрипторов
+        const unsigned long long capacity = m_capacity;
+        m_mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                       static_cast<DWORD>(capacity >> 32),
+                                       static_cast<DWORD>(capacity & 0xFFFFFFFFull), nullptr);
+        if (!m_mapping) return false;
+        m_payload = static_cast<char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+        if (!m_payload) return false;
+    }
+
+    HANDLE jobRead = nullptr;
+    HANDLE replyWrite = nullptr;
+    if (!CreatePipe(&jobRead, &m_jobWrite, &inheritable, 0)) return false;
+    if (!CreatePipe(&m_replyRead, &replyWrite, &inheritable, 0)) {
+        CloseHandle(jobRead);
+        stop();
+        return false;
+    }
+    SetHandleInformation(m_jobWrite, HANDLE_FLAG_INHERIT, 0);
+    SetHandleInformation(m_replyRead, HANDLE_FLAG_INHERIT, 0);
+
+    char self[MAX_PATH];
+    GetModuleFileNameA(nullptr, self, MAX_PATH);
+    std::ostringstream command;
+    command << '"' << self << "\" --worker "
+            << reinterpret_cast<std::uintptr_t>(jobRead) << ' '
+            << reinterpret_cast<std::uintptr_t>(replyWrite) << ' '
+            << reinterpret_cast<std::uintptr_t>(m_mapping) << ' '
+            << m_capacity << ' ' << formatName(m_options.format) << ' ' << pipelineName(m_options.pipeline)
+            << ' ' << ShaftValidator::levelName(m_options.checkLevel) << ' ' << (m_options.compaction ? "compact" : "full");
+    std::string commandLine = command.str();
+
+    // Рабочий наследует только свои каналы и отображение, а не дескрипторы других рабочих
+    HANDLE inherited[] = {jobRead, replyWrite, m_mapping};
+    SIZE_T attributeSize = 0;
+    InitializeProcThreadAttributeList(nullptr, 1, 0, &attributeSize);
+    std::vector<char> attributeBuffer(attributeSize);
+    STARTUPINFOEXA startup = {};
+    startup.StartupInfo.cb = sizeof(startup);
+    startup.lpAttributeList = reinterpret_cast<LPPROC_THREAD_ATTRIBUTE_LIST>(attributeBuffer.data());
+    BOOL created = FALSE;
+    PROCESS_INFORMATION info = {};
+    if (InitializeProcThreadAttributeList(startup.lpAttributeList, 1, 0, &attributeSize)) {
+        if (UpdateProcThreadAttribute(startup.lpAttributeList, 0, PROC_THREAD_ATTRIBUTE_HANDLE_LIST,
+                                      inherited, sizeof(inherited), nullptr, nullptr)) {
+            // Дескрипторы списка должны быть наследуемыми; отображение становится им только на время запуска
+            SetHandleInformation(m_mapping, HANDLE_FLAG_INHERIT, HANDLE_FLAG_INHERIT);
+            created = CreateProcessA(nullptr, &commandLine[0], nullptr, nullptr, TRUE,
+                                     CREATE_SUSPENDED | CREATE_NO_WINDOW | EXTENDED_STARTUPINFO_PRESENT,
+                                     nullptr, nullptr, &startup.StartupInfo, &info);
+            SetHandleInformation(m_mapping, HANDLE_FLAG_INHERIT, 0);
+        }
+        DeleteProcThreadAttributeList(startup.lpAttributeList);
+    }
+    CloseHandle(jobRead);
+    CloseHandle(replyWrite);
+    if (!created) {
+        stop();
+        return false;
+    }
+    m_process = info.hProcess;
+
+    if (m_options.memoryLimitMb > 0) {
+        m_job = CreateJobObjectA(nullptr, nullptr);
+        JOBOBJECT_EXTENDED_LIMIT_INFORMATION limits = {};
+        limits.BasicLimitInformation.LimitFlags = JOB_OBJECT_LIMIT_PROCESS_MEMORY | JOB_OBJECT_LIMIT_KILL_ON_JOB_CLOSE;
+        limits.ProcessMemoryLimit = static_cast<SIZE_T>(m_options.memoryLimitMb) * 1024 * 1024;
+        if (m_job) {
+            SetInformationJobObject(m_job, JobObjectExtendedLimitInformation, &limits, sizeof(limits));
+            AssignProcessToJobObject(m_job, m_process);
+        }
+    }
+    ResumeThread(info.hThread);
+    CloseHandle(info.hThread);
+    return true;
+}
+
+void WorkerProcess::stop() {
+    if (m_process) {
+        TerminateProcess(m_process, 1);
+        WaitForSingleObject(m_process, INFINITE);
+        CloseHandle(m_process);
+        m_process = nullptr;
+    }
+    if (m_job) {
+        CloseHandle(m_job);
+        m_job = nullptr;
+    }
+    if (m_jobWrite) {
+        CloseHandle(m_jobWrite);
+        m_jobWrite = nullptr;
+    }
+    if (m_replyRead) {
+        CloseHandle(m_replyRead);
+        m_replyRead = nullptr;
+    }
+    m_pending.clear();
+}
+
+void WorkerProcess::releasePayload() {
+    if (m_payload) UnmapViewOfFile(m_payload);
+    if (m_mapping) CloseHandle(m_mapping);
+    m_payload = nullptr;
+    m_mapping = nullptr;
+}
+
+bool WorkerProcess::send(const std::string& line) {
+    DWORD written = 0;
+    return WriteFile(m_jobWrite, line.data(), static_cast<DWORD>(line.size()), &written, nullptr)
+           && written == line.size();
+}
+
+WorkerProcess::State WorkerProcess::poll(std::string& reply) {
+    if (takeLine(reply)) return State::Ready;
+    DWORD available = 0;
+    if (!PeekNamedPipe(m_replyRead, nullptr, 0, nullptr, &available, nullptr)) return State::Died;
+    if (available > 0) {
+        std::string buffer(available, '\0');
+        DWORD read = 0;
+        if (!ReadFile(m_replyRead, &buffer[0], available, &read, nullptr)) return State::Died;
+        m_pending.append(buffer.data(), read);
+        if (takeLine(reply)) return State::Ready;
+    }
+    return WaitForSingleObject(m_process, 0) == WAIT_OBJECT_0 ? State::Died : State::Pending;
+}
+
+size_t WorkerProcess::residentMb() const {
+    return 0;
+}
+
+#else
+
+/**
+ * @brief Путь к исполняемому файлу: рабочие процессы запускаются им же с ключом --worker
+ */
+std::string selfExecutable() {
+    char path[PATH_MAX];
+#ifdef __APPLE__
+    uint32_t size = sizeof(path);
+    if (_NSGetExecutablePath(path, &size) == 0) return path;
+#else
+    ssize_t length = readlink("/proc/self/exe", path, sizeof(path));
+    if (length > 0 && static_cast<size_t>(length) < sizeof(path)) return std::string(path, static_cast<size_t>(length));
+#endif
+    return std::string();
+}
+
+bool setCloseOnExec(int fd, bool enabled) {
+    int flags = fcntl(fd, F_GETFD);
+    if (flags < 0) return false;
+    return fcntl(fd, F_SETFD, enabled ? (flags | FD_CLOEXEC) : (flags & ~FD_CLOEXEC)) == 0;
+}
+
+/**
+ * @brief Канал, оба конца которого закрываются при exec, чтобы не попасть в чужие рабочие процессы
+ */
+bool openPipe(int fds[2]) {
+    if (pipe(fds) != 0) return false;
+    if (setCloseOnExec(fds[0], true) && setCloseOnExec(fds[1], true)) return true;
+    close(fds[0]);
+    close(fds[1]);
+    return false;
+}
+
+bool WorkerProcess::start() {
+    if (!m_payload) {
+        // Безымянный объект общей памяти: рабочий процесс получает только свой дескриптор
+        static unsigned counter = 0;
+        const std::string name = "/shaft-payload-" + std::to_string(getpid()) + "-" + std::to_string(++counter);
+        int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd < 0) return false;
+        shm_unlink(name.c_str());
+        void* mapping = MAP_FAILED;
+        if (setCloseOnExec(fd, true) && ftruncate(fd, static_cast<off_t>(m_capacity)) == 0) {
+            mapping = mmap(nullptr, m_capacity, PROT_READ, MAP_SHARED, fd, 0);
+        }
+        if (mapping == MAP_FAILED) {
+            close(fd);
+            return false;
+        }
+        m_payloadFd = fd;
+        m_payload = static_cast<char*>(mapping);
+    }
+
+    const std::string executable = selfExecutable();
+    if (executable.empty()) return false;
+    int jobPipe[2];
+    int replyPipe[2];
+    if (!openPipe(jobPipe)) return false;
+    if (!openPipe(replyPipe)) {
+        close(jobPipe[0]);
+        close(jobPipe[1]);
+        return false;
+    }
+
+    // Аргументы готовятся до fork: между fork и exec допустимы только async-signal-safe вызовы
+    std::vector<std::string> arguments = {
+        executable, "--worker", std::to_string(jobPipe[0]), std::to_string(replyPipe[1]),
+        std::to_string(m_payloadFd), std::to_string(m_capacity), formatName(m_options.format),
+        pipelineName(m_options.pipeline), ShaftValidator::levelName(m_options.checkLevel),
+        m_options.compaction ? "compact" : "full"};
+    std::vector<char*> argv;
+    for (std::string& argument : arguments) argv.push_back(&argument[0]);
+    argv.push_back(nullptr);
+
+    std::cout.flush();
+    std::cerr.flush();
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(jobPipe[0]);
+        close(jobPipe[1]);
+        close(replyPipe[0]);
+        close(replyPipe[1]);
+        return false;
+    }
+    if (pid == 0) {
+        // Новый образ процесса не наследует ни пул потоков родителя, ни каналы и память других рабочих
+        setCloseOnExec(jobPipe[0], false);
+        setCloseOnExec(replyPipe[1], false);
+        setCloseOnExec(m_payloadFd, false);
+        execv(argv[0], argv.data());
+        _exit(127);
+    }
+
+    close(jobPipe[0]);
+    close(replyPipe[1]);
+    m_pid = pid;
+    m_jobFd = jobPipe[1];
+    m_replyFd = replyPipe[0];
+    fcntl(m_replyFd, F_SETFL, fcntl(m_replyFd, F_GETFL) | O_NONBLOCK);
+    return true;
+}
+
+void WorkerProcess::stop() {
+    if (m_pid > 0) {
+        kill(m_pid, SIGKILL);
+        waitpid(m_pid, nullptr, 0);
+        m_pid = -1;
+    }
+    if (m_jobFd >= 0) {
+        close(m_jobFd);
+        m_jobFd = -1;
+    }
+    if (m_replyFd >= 0) {
+        close(m_replyFd);
+        m_replyFd = -1;
+    }
+    m_pending.clear();
+}
+
+void WorkerProcess::releasePayload() {
+    if (m_payload) munmap(m_payload, m_capacity);
+    if (m_payloadFd >= 0) close(m_payloadFd);
+    m_payload = nullptr;
+    m_payloadFd = -1;
+}
+
+bool WorkerProcess::send(const std::string& line) {
+    size_t offset = 0;
+    while (offset < line.size()) {
+        ssize_t written = write(m_jobFd, line.data() + offset, line.size() - offset);
+        if (written < 0 && errno == EINTR) continue;
+        if (written <= 0) return false;
+        offset += static_cast<size_t>(written);
+    }
+    return true;
+}
+
+WorkerProcess::State WorkerProcess::poll(std::string& reply) {
+    if (takeLine(reply)) return State::Ready;
+    bool closed = false;
+    char buffer[256];
+    for (;;) {
+        ssize_t count = read(m_replyFd, buffer, sizeof(buffer));
+        if (count > 0) {
+            m_pending.append(buffer, static_cast<size_t>(count));
+            continue;
+        }
+        if (count < 0 && errno == EINTR) continue;
+        closed = count == 0 || (errno != EAGAIN && errno != EWOULDBLOCK);
+        break;
+    }
+    if (takeLine(reply)) return State::Ready;
+    return closed ? State::Died : State::Pending;
+}
+
+size_t WorkerProcess::residentMb() const {
+    if (m_pid <= 0) return 0;
+    std::ifstream statm("/proc/" + std::to_string(m_pid) + "/statm");
+    size_t totalPages = 0;
+    size_t residentPages = 0;
+    if (!(statm >> totalPages >> residentPages)) return 0;
+    return residentPages * static_cast<size_t>(sysconf(_SC_PAGESIZE)) / (1024 * 1024);
+}
+
+#endif
+
+/**
+ * @struct WorkerSlot
+ * @brief Рабочий процесс пула и выполняемое им задание
+ */
+struct WorkerSlot {
+    std::unique_ptr<WorkerProcess> process;
+    bool alive = false;
+    bool busy = false;
+    size_t jobIndex = 0;
+    Clock::time_point started;
+    Clock::time_point memoryChecked;
+};
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+} // namespace
+
+BatchRunner::BatchRunner(const BatchOptions& options) : m_options(options) {}
+
+std::vector<BatchJobResult> BatchRunner::run(const std::vector<BatchJob>& jobs) {
+    return run(jobs, [&jobs](size_t jobIndex, const char* data, size_t size, std::string& error) {
+        std::ofstream output(jobs[jobIndex].outputFile, std::ios::binary);
+        if (!output) {
+            error = "cannot open " + jobs[jobIndex].outputFile;
+            return false;
+        }
+        output.write(data, static_cast<std::streamsize>(size));
+        if (!output) {
+            error = "cannot write " + jobs[jobIndex].outputFile;
+            return false;
+        }
+        return true;
+    });
+}
+
+std::vector<BatchJobResult> BatchRunner::run(const std::vector<BatchJob>& jobs, const PayloadHandler& handler) {
+    std::vector<BatchJobResult> results(jobs.size());
+    if (jobs.empty()) return results;
+
+#ifndef _WIN32
+    // Запись в канал упавшего процесса не должна завершать родителя
+    signal(SIGPIPE, SIG_IGN);
+#endif
+
+    size_t workerCount = m_options.workerCount > 0
+        ? static_cast<size_t>(m_options.workerCount)
+        : static_cast<size_t>(std::thread::hardware_concurrency());
+    if (workerCount == 0) workerCount = 1;
+    if (workerCount > jobs.size()) workerCount = jobs.size();
+
+    std::vector<WorkerSlot> workers(workerCount);
+    size_t aliveCount = 0;
+    for (WorkerSlot& worker : workers) {
+        worker.process = std::make_unique<WorkerProcess>(m_options);
+        worker.alive = worker.process->start();
+        if (worker.alive) ++aliveCount;
+    }
+    std::cout << "Started " << aliveCount << " of " << workerCount << " worker processes" << std::endl;
+
+    std::deque<size_t> queue;
+    for (size_t i = 0; i < jobs.size(); ++i) queue.push_back(i);
+    size_t finished = 0;
+
+    auto failAttempt = [&](size_t jobIndex, const std::string& reason) {
+        BatchJobResult& result = results[jobIndex];
+        result.error = reason;
+        if (result.attempts <= m_options.maxRetries) {
+            std::cout << "Job " << jobs[jobIndex].name << " failed (" << reason << "), retrying" << std::endl;
+            queue.push_front(jobIndex);
+        } else {
+            std::cout << "Job " << jobs[jobIndex].name << " failed: " << reason << std::endl;
+            ++finished;
+        }
+    };
+
+    auto restartWorker = [&](WorkerSlot& worker) {
+        worker.process->stop();
+        worker.busy = false;
+        worker.alive = worker.process->start();
+        if (!worker.alive) {
+            --aliveCount;
+            std::cerr << "Error: failed to restart worker process" << std::endl;
+        }
+    };
+
+    while (finished < jobs.size()) {
+        if (aliveCount == 0) {
+            while (!queue.empty()) {
+                results[queue.front()].error = "no worker processes available";
+                queue.pop_front();
+                ++finished;
+            }
+            break;
+        }
+
+        bool progressed = false;
+        for (WorkerSlot& worker : workers) {
+            if (!worker.alive) continue;
+
+            if (!worker.busy) {
+                if (queue.empty()) continue;
+                size_t jobIndex = queue.front();
+                queue.pop_front();
+                const BatchJob& job = jobs[jobIndex];
+                // Размеры передаются без округления: рабочий строит тот же вал, что описан в задании
+                std::ostringstream request;
+                request << std::setprecision(std::numeric_limits<double>::max_digits10);
+                request << jobIndex << ' ' << job.totalLength << ' '
+                        << job.cylinder4Diameter << ' ' << job.cylinder9Diameter << "\n";
+                ++results[jobIndex].attempts;
+                worker.jobIndex = jobIndex;
+                worker.started = Clock::now();
+                worker.busy = true;
+                if (!worker.process->send(request.str())) {
+                    restartWorker(worker);
+                    failAttempt(jobIndex, "worker process is not responding");
+                }
+                progressed = true;
+                continue;
+            }
+
+            std::string reply;
+            WorkerProcess::State state = worker.process->poll(reply);
+            const size_t jobIndex = worker.jobIndex;
+            BatchJobResult& result = results[jobIndex];
+
+            if (state == WorkerProcess::State::Ready) {
+                result.seconds = secondsSince(worker.started);
+                worker.busy = false;
+                progressed = true;
+
+                std::istringstream parsed(reply);
+                size_t replyIndex = 0;
+                std::string status;
+                parsed >> replyIndex >> status;
+                if (replyIndex != jobIndex) {
+                    restartWorker(worker);
+                    failAttempt(jobIndex, "unexpected reply from worker process");
+                } else if (status == "ok") {
+                    size_t size = 0;
+                    parsed >> size;
+                    std::string error;
+                    if (size <= worker.process->capacity() &&
+                        handler(jobIndex, worker.process->payload(), size, error)) {
+                        result.success = true;
+                        result.payloadSize = size;
+                        result.error.clear();
+                        ++finished;
+                    } else {
+                        result.error = error.empty() ? "invalid payload size" : error;
+                        ++finished;
+                    }
+                } else {
+                    std::string message;
+                    std::getline(parsed >> std::ws, message);
+                    // Ошибка построения детерминирована, повтор не поможет
+                    result.error = message;
+                    std::cout << "Job " << jobs[jobIndex].name << " failed: " << message << std::endl;
+                    ++finished;
+                }
+            } else if (state == WorkerProcess::State::Died) {
+                result.seconds = secondsSince(worker.started);
+                restartWorker(worker);
+                failAttempt(jobIndex, "worker process crashed or exceeded the memory limit");
+                progressed = true;
+            } else if (m_options.jobTimeoutSeconds > 0.0 && secondsSince(worker.started) > m_options.jobTimeoutSeconds) {
+                result.seconds = secondsSince(worker.started);
+                restartWorker(worker);
+                failAttempt(jobIndex, "time limit exceeded");
+                progressed = true;
+            } else if (m_options.memoryLimitMb > 0 && secondsSince(worker.memoryChecked) > 0.05) {
+                // Ограничивается резидентная память, а не адресное пространство с пулами потоков OCCT
+                worker.memoryChecked = Clock::now();
+                if (worker.process->residentMb() > m_options.memoryLimitMb) {
+                    result.seconds = secondsSince(worker.started);
+                    restartWorker(worker);
+                    failAttempt(jobIndex, "memory limit exceeded");
+                    progressed = true;
+                }
+            }
+        }
+
+        if (!progressed) std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+
+    for (WorkerSlot& worker : workers) worker.process->stop();
+    return results;
+}
+
+std::vector<BatchJob> BatchRunner::loadJobs(const std::string& filename, ExportFormat format) {
+    std::ifstream input(filename);
+    if (!input) throw std::runtime_error("Cannot open job file " + filename);
+
+    std::vector<BatchJob> jobs;
+    std::string line;
+    size_t lineNumber = 0;
+    while (std::getline(input, line)) {
+        ++lineNumber;
+        std::istringstream fields(line);
+        BatchJob job;
+        if (!(fields >> job.name) || job.name[0] == '#') continue;
+        if (!(fields >> job.totalLength >> job.cylinder4Diameter >> job.cylinder9Diameter)) {
+            throw std::runtime_error("Malformed job at line " + std::to_string(lineNumber) + " of " + filename);
+        }
+        if (job.totalLength <= 200 || job.totalLength >= 300 ||
+            job.cylinder4Diameter <= 20 || job.cylinder4Diameter >= 35 ||
+            job.cylinder9Diameter <= 20 || job.cylinder9Diameter >= 35) {
+            throw std::runtime_error("Job " + job.name + " at line " + std::to_string(lineNumber) +
+                                     " is out of the valid range (length 200-300mm, diameters 20-35mm)");
+        }
+        if (!(fields >> job.outputFile)) {
+            job.outputFile = job.name + (format == ExportFormat::BRep ? ".brep" : ".step");
+        }
+        jobs.push_back(job);
+    }
+    return jobs;
+}
+
+int BatchRunner::workerMain(int argc, char* argv[]) {
+#ifdef _WIN32
+    if (argc < 10) {
+        std::cerr << "Error: invalid worker arguments" << std::endl;
+        return 1;
+    }
+    HANDLE jobRead = reinterpret_cast<HANDLE>(static_cast<std::uintptr_t>(std::stoull(argv[2])));
+    HANDLE replyWrite = reinterpret_cast<HANDLE>(static_cast<std::uintptr_t>(std::stoull(argv[3])));
+    HANDLE mapping = reinterpret_cast<HANDLE>(static_cast<std::uintptr_t>(std::stoull(argv[4])));
+    size_t capacity = static_cast<size_t>(std::stoull(argv[5]));
+    ExportFormat format = std::string(argv[6]) == "brep" ? ExportFormat::BRep : ExportFormat::STEP;
+    FeaturePipeline pipeline = std::string(argv[7]) == "local" ? FeaturePipeline::SegmentLocal : FeaturePipeline::Global;
+    CheckLevel checkLevel = ShaftValidator::parseLevel(argv[8]);
+    bool compaction = std::string(argv[9]) == "compact";
+
+    char* payload = static_cast<char*>(MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, 0));
+    FILE* jobs = _fdopen(_open_osfhandle(reinterpret_cast<intptr_t>(jobRead), _O_RDONLY), "r");
+    FILE* replies = _fdopen(_open_osfhandle(reinterpret_cast<intptr_t>(replyWrite), _O_WRONLY), "w");
+    if (!payload || !jobs || !replies) {
+        std::cerr << "Error: cannot attach worker to its channels" << std::endl;
+        return 1;
+    }
+    return workerLoop(jobs, replies, payload, capacity, format, pipeline, checkLevel, compaction);
+#else
+    if (argc < 10) {
+        std::cerr << "Error: invalid worker arguments" << std::endl;
+        return 1;
+    }
+    int jobFd = std::stoi(argv[2]);
+    int replyFd = std::stoi(argv[3]);
+    int payloadFd = std::stoi(argv[4]);
+    size_t capacity = static_cast<size_t>(std::stoull(argv[5]));
+    ExportFormat format = std::string(argv[6]) == "brep" ? ExportFormat::BRep : ExportFormat::STEP;
+    FeaturePipeline pipeline = std::string(argv[7]) == "local" ? FeaturePipeline::SegmentLocal : FeaturePipeline::Global;
+    CheckLevel checkLevel = ShaftValidator::parseLevel(argv[8]);
+    bool compaction = std::string(argv[9]) == "compact";
+
+    void* mapping = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, payloadFd, 0);
+    close(payloadFd);
+    FILE* jobs = fdopen(jobFd, "r");
+    FILE* replies = fdopen(replyFd, "w");
+    if (mapping == MAP_FAILED || !jobs || !replies) {
+        std::cerr << "Error: cannot attach worker to its channels" << std::endl;
+        return 1;
+    }
+    return workerLoop(jobs, replies, static_cast<char*>(mapping), capacity, format, pipeline, checkLevel, compaction);
+#endif
+}
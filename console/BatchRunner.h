@@ -0,0 +1,97 @@
+#ifndef BATCH_RUNNER_H
+#define BATCH_RUNNER_H
+
+#include "../lib/ShaftAppCore.h"
+#include <string>
+#include <vector>
+#include <functional>
+#include <cstddef>
+
+/**
+ * @struct BatchJob
+ * @brief Задание пакетного построения: параметры вала и файл результата
+ */
+struct BatchJob {
+    std::string name;          // Имя задания
+    double totalLength;        // Общая длина вала
+    double cylinder4Diameter;  // Диаметр 4-го цилиндра
+    double cylinder9Diameter;  // Диаметр 9-го цилиндра
+    std::string outputFile;    // Файл для записи результата
+};
+
+/**
+ * @struct BatchJobResult
+ * @brief Итог выполнения задания пакетного построения
+ */
+struct BatchJobResult {
+    bool success = false;      // Задание выполнено
+    int attempts = 0;          // Число попыток (с учётом перезапусков рабочих процессов)
+    double seconds = 0.0;      // Время последней попытки, с
+    size_t payloadSize = 0;    // Размер результата, байт
+    std::string error;         // Причина неудачи
+};
+
+/**
+ * @struct BatchOptions
+ * @brief Настройки пула рабочих процессов
+ */
+struct BatchOptions {
+    int workerCount = 0;                                // Число рабочих процессов, 0 - по числу ядер
+    double jobTimeoutSeconds = 300.0;                   // Ограничение времени на задание, с
+    size_t memoryLimitMb = 4096;                        // Ограничение резидентной памяти рабочего процесса, МБ (0 - без ограничения)
+    int maxRetries = 1;                                 // Число повторов задания после сбоя
+    size_t payloadCapacityMb = 64;                      // Размер общей памяти одного рабочего процесса, МБ
+    ExportFormat format = ExportFormat::STEP;           // Формат результата
+    FeaturePipeline pipeline = FeaturePipeline::Global; // Порядок применения пазов
+    CheckLevel checkLevel = CheckLevel::Fast;           // Проверка геометрии в рабочем процессе
+    bool compaction = false;                            // Слияние граней одной поверхности перед экспортом
+};
+
+/**
+ * @class BatchRunner
+ * @brief Пакетное построение валов пулом рабочих процессов
+ *
+ * Рабочий процесс - новый экземпляр исполняемого файла с ключом --worker: он не наследует
+ * потоки, каналы и общую память родителя и других рабочих процессов.
+ * Каждый рабочий процесс владеет своим ShaftAppCore, получает задания по каналу
+ * и возвращает результат через общую память. Упавший или превысивший ограничения
+ * процесс перезапускается, а его задание повторяется или помечается неудачным.
+ */
+class BatchRunner {
+public:
+    /**
+     * @brief Обработчик результата: получает данные из общей памяти рабочего процесса
+     * @return true, если результат принят; иначе error содержит причину
+     */
+    using PayloadHandler = std::function<bool(size_t jobIndex, const char* data, size_t size, std::string& error)>;
+
+    explicit BatchRunner(const BatchOptions& options);
+
+    /**
+     * @brief Выполнить задания, записывая результаты в outputFile каждого задания
+     */
+    std::vector<BatchJobResult> run(const std::vector<BatchJob>& jobs);
+
+    /**
+     * @brief Выполнить задания, передавая результаты обработчику
+     */
+    std::vector<BatchJobResult> run(const std::vector<BatchJob>& jobs, const PayloadHandler& handler);
+
+    /**
+     * @brief Прочитать список заданий из файла
+     *
+     * Каждая строка: имя, общая длина, диаметр 4-го и 9-го цилиндров и, необязательно,
+     * имя выходного файла. Пустые строки и строки, начинающиеся с '#', пропускаются.
+     */
+    static std::vector<BatchJob> loadJobs(const std::string& filename, ExportFormat format);
+
+    /**
+     * @brief Точка входа рабочего процесса, запущенного с ключом --worker
+     */
+    static int workerMain(int argc, char* argv[]);
+
+private:
+    BatchOptions m_options;
+};
+
+#endif // BATCH_RUNNER_H
@@ -0,0 +1,175 @@
+#include "GoldenSuite.h"
+#include "ScalingBenchmark.h"
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+/**
+ * @brief Построить все пары (вариант, построитель) параллельно
+ *
+ * Журнал построителя на время прогона отключается: сообщения параллельных
+ * построений перемешались бы и замедлили прогон.
+ */
+std::vector<GoldenSuite::Result> GoldenSuite::buildAll(const std::vector<GoldenCase>& cases,
+                                                       const std::vector<BuildEngine>& engines) {
+    const size_t taskCount = cases.size() * engines.size();
+    std::vector<Result> results(taskCount);
+    std::streambuf* previousOutput = std::cout.rdbuf(nullptr);
+    std::cout.setstate(std::ios::badbit);
+    OSD_Parallel::For(0, static_cast<Standard_Integer>(taskCount), [&](Standard_Integer task) {
+        const GoldenCase& goldenCase = cases[task / engines.size()];
+        const BuildEngine& engine = engines[task % engines.size()];
+        try {
+            results[task].signature = buildSignature(goldenCase, engine);
+        } catch (const Standard_Failure& e) {
+            results[task].error = e.GetMessageString();
+        } catch (const std::exception& e) {
+            results[task].error = e.what();
+        }
+    });
+    std::cout.rdbuf(previousOutput);
+    std::cout.clear();
+    return results;
+}
+
+std::vector<GoldenCase> GoldenSuite::defaultGrid() {
+    std::vector<GoldenCase> cases;
+    const double lengths[] = {201.0, 230.0, 265.0, 299.0};
+    const double diameters4[] = {21.0, 23.0, 28.0, 34.0};
+    const double diameters9[] = {21.0, 27.0, 34.0};
+    for (double length : lengths) {
+        for (double d4 : diameters4) {
+            for (double d9 : diameters9) {
+                std::ostringstream name;
+                name << "L" << length << "_d4_" << d4 << "_d9_" << d9;
+                cases.push_back(GoldenCase{name.str(), ShaftProportions(length, d4, d9)});
+            }
+        }
+    }
+    // Многосегментные схемы проверяют пазы на разных сегментах, канавки и конусы
+    for (size_t segmentCount : {size_t(4), size_t(9), size_t(16)}) {
+        cases.push_back(GoldenCase{"stepped_" + std::to_string(segmentCount),
+                                   ScalingBenchmark::makeSteppedShaft(segmentCount)});
+    }
+    return cases;
+}
+
+std::vector<BuildEngine> GoldenSuite::engines() {
+    // Слияние граней меняет топологию, поэтому построители со слиянием сравниваются с
+    // эталоном, построенным с тем же слиянием, и топология всегда должна совпадать точно
+    const SignatureTolerances tolerances;
+    return {
+        BuildEngine{"reference", FeaturePipeline::Sequential, false, tolerances},
+        BuildEngine{"global", FeaturePipeline::Global, false, tolerances},
+        BuildEngine{"segment-local", FeaturePipeline::SegmentLocal, false, tolerances},
+        BuildEngine{"reference-compact", FeaturePipeline::Sequential, true, tolerances},
+        BuildEngine{"global-compact", FeaturePipeline::Global, true, tolerances},
+        BuildEngine{"segment-local-compact", FeaturePipeline::SegmentLocal, true, tolerances},
+    };
+}
+
+/**
+ * @brief Имя сигнатуры в файле эталона: вариант и слияние граней построителя
+ */
+std::string GoldenSuite::goldenKey(const GoldenCase& goldenCase, const BuildEngine& engine) {
+    return engine.compaction ? goldenCase.name + "@compact" : goldenCase.name;
+}
+
+ShaftSignature GoldenSuite::buildSignature(const GoldenCase& goldenCase, const BuildEngine& engine) {
+    ShaftBuilder builder;
+    builder.setFeaturePipeline(engine.pipeline);
+    builder.setCompaction(engine.compaction);
+    builder.buildFromProportions(goldenCase.proportions);
+    builder.build();
+    return ShaftSignature::measure(builder.getFinalShape());
+}
+
+int GoldenSuite::record(const std::string& filename) {
+    const std::vector<GoldenCase> cases = defaultGrid();
+    std::vector<BuildEngine> references;
+    for (const BuildEngine& engine : engines()) {
+        if (engine.isReference()) references.push_back(engine);
+    }
+    auto start = std::chrono::steady_clock::now();
+    std::vector<Result> results = buildAll(cases, references);
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::ofstream output(filename);
+    if (!output) {
+        std::cerr << "Error: cannot open golden file " << filename << std::endl;
+        return 1;
+    }
+    output << "# Golden shaft signatures recorded by the sequential reference engines; <case>@compact - with face compaction\n";
+    for (size_t i = 0; i < cases.size(); ++i) {
+        for (size_t e = 0; e < references.size(); ++e) {
+            const Result& result = results[i * references.size() + e];
+            if (!result.error.empty()) {
+                std::cerr << "Error: " << cases[i].name << " [" << references[e].name << "] failed to build: "
+                          << result.error << std::endl;
+                return 1;
+            }
+            output << goldenKey(cases[i], references[e]) << ' ';
+            result.signature.write(output);
+            output << '\n';
+        }
+    }
+    if (!output) {
+        std::cerr << "Error: cannot write golden file " << filename << std::endl;
+        return 1;
+    }
+    std::cout << results.size() << " golden signatures written to " << filename << " in " << elapsed << " s" << std::endl;
+    return 0;
+}
+
+int GoldenSuite::verify(const std::string& filename) {
+    std::ifstream input(filename);
+    if (!input) {
+        std::cerr << "Error: cannot open golden file " << filename
+                  << " (record it with Console --golden record " << filename << ")" << std::endl;
+        return 1;
+    }
+    std::map<std::string, ShaftSignature> golden;
+    std::string line;
+    while (std::getline(input, line)) {
+        std::istringstream fields(line);
+        std::string name;
+        if (!(fields >> name) || name[0] == '#') continue;
+        ShaftSignature signature;
+        if (!signature.read(fields)) {
+            std::cerr << "Error: malformed golden signature " << name << std::endl;
+            return 1;
+        }
+        golden[name] = signature;
+    }
+
+    const std::vector<GoldenCase> cases = defaultGrid();
+    const std::vector<BuildEngine> buildEngines = engines();
+    auto start = std::chrono::steady_clock::now();
+    std::vector<Result> results = buildAll(cases, buildEngines);
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    size_t failures = 0;
+    for (size_t i = 0; i < cases.size(); ++i) {
+        for (size_t e = 0; e < buildEngines.size(); ++e) {
+            auto expected = golden.find(goldenKey(cases[i], buildEngines[e]));
+            const Result& result = results[i * buildEngines.size() + e];
+            std::vector<std::string> differences;
+            if (expected == golden.end()) {
+                differences.push_back("no golden signature");
+            } else if (!result.error.empty()) {
+                differences.push_back("build failed: " + result.error);
+            } else {
+                differences = result.signature.compare(expected->second, buildEngines[e].tolerances);
+            }
+            if (differences.empty()) continue;
+            ++failures;
+            std::cout << "MISMATCH " << cases[i].name << " [" << buildEngines[e].name << "]:" << std::endl;
+            for (const std::string& difference : differences) std::cout << "  " << difference << std::endl;
+        }
+    }
+    std::cout << cases.size() << " cases x " << buildEngines.size() << " engines checked in " << elapsed
+              << " s: " << failures << " mismatch(es)" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,78 @@
+#ifndef GOLDEN_SUITE_H
+#define GOLDEN_SUITE_H
+
+#include "../lib/ShaftBuilder.h"
+#include "../lib/ShaftSignature.h"
+#include <string>
+#include <vector>
+
+/**
+ * @struct GoldenCase
+ * @brief Вариант вала из сетки проверки
+ */
+struct GoldenCase {
+    std::string name;
+    ShaftProportions proportions;
+};
+
+/**
+ * @struct BuildEngine
+ * @brief Настройка построения, результат которой сравнивается с эталоном
+ */
+struct BuildEngine {
+    std::string name;
+    FeaturePipeline pipeline;
+    bool compaction;  // Слияние граней одной поверхности после объединения
+    SignatureTolerances tolerances;
+
+    /**
+     * @brief Эталонный построитель: исходный порядок построения (FeaturePipeline::Sequential)
+     */
+    bool isReference() const { return pipeline == FeaturePipeline::Sequential; }
+};
+
+/**
+ * @class GoldenSuite
+ * @brief Эталонные сигнатуры вала по сетке параметров и проверка построителей на совпадение с ними
+ *
+ * Эталон записывается эталонными построителями - исходным порядком построения без
+ * ускорений, со слиянием граней и без него, - и хранится в репозитории. При проверке
+ * каждый вариант сетки строится каждым настроенным построителем и сравнивается с
+ * сигнатурой эталона с тем же слиянием граней; варианты обрабатываются параллельно.
+ */
+class GoldenSuite {
+public:
+    /**
+     * @brief Сетка: длины и диаметры на границах и внутри допустимых диапазонов и схемы со многими сегментами
+     */
+    static std::vector<GoldenCase> defaultGrid();
+
+    /**
+     * @brief Настроенные построители, включая эталонные
+     */
+    static std::vector<BuildEngine> engines();
+
+    /**
+     * @brief Построить сетку эталонными построителями и записать сигнатуры
+     * @return 0 при успехе
+     */
+    static int record(const std::string& filename);
+
+    /**
+     * @brief Построить сетку всеми построителями и сравнить с сигнатурами из файла
+     * @return 0, если все результаты совпадают с эталоном
+     */
+    static int verify(const std::string& filename);
+
+private:
+    struct Result {
+        ShaftSignature signature;
+        std::string error;  // Сообщение об ошибке построения
+    };
+
+    static std::string goldenKey(const GoldenCase& goldenCase, const BuildEngine& engine);
+    static std::vector<Result> buildAll(const std::vector<GoldenCase>& cases, const std::vector<BuildEngine>& engines);
+    static ShaftSignature buildSignature(const GoldenCase& goldenCase, const BuildEngine& engine);
+};
+
+#endif // GOLDEN_SUITE_H
@@ -0,0 +1,94 @@
+#include "ScalingBenchmark.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+ShaftProportions ScalingBenchmark::makeSteppedShaft(size_t segmentCount) {
+    const double segmentLength = 20.0;
+    const double lengthRatio = 1.0 / static_cast<double>(segmentCount);
+    std::vector<ShaftSegmentProportion> segments;
+    std::vector<SlotProportion> slots;
+    segments.reserve(segmentCount);
+    for (size_t i = 0; i < segmentCount; ++i) {
+        std::string name = "Step " + std::to_string(i + 1);
+        switch (i % 4) {
+        case 0:
+            segments.push_back(ShaftSegmentProportion(name, "cylinder", lengthRatio, 1.0));
+            // Паз целиком внутри сегмента: от 3 до 13 мм с учётом скруглений
+            slots.push_back(SlotProportion(4.0, 2.0, 6.0, 5.0, static_cast<int>(i)));
+            break;
+        case 1:
+            segments.push_back(ShaftSegmentProportion(name, "cylinder", lengthRatio, 1.0, 0.0, true));
+            break;
+        case 2:
+            segments.push_back(ShaftSegmentProportion(name, "cylinder", lengthRatio, 1.2));
+            break;
+        default:
+            segments.push_back(ShaftSegmentProportion(name, "cone", lengthRatio, 1.2, 1.0));
+            break;
+        }
+    }
+    ShaftProportions proportions(segmentLength * static_cast<double>(segmentCount));
+    proportions.setLayout(segments, slots);
+    return proportions;
+}
+
+std::vector<ScalingSample> ScalingBenchmark::run(const std::vector<size_t>& segmentCounts) const {
+    std::vector<ScalingSample> samples;
+    for (size_t segmentCount : segmentCounts) {
+        ShaftProportions proportions = makeSteppedShaft(segmentCount);
+
+        // Журнал построения не входит в замер
+        std::streambuf* previousOutput = std::cout.rdbuf(nullptr);
+        double seconds = 0.0;
+        for (int attempt = 0; attempt < m_repeats; ++attempt) {
+            auto start = std::chrono::steady_clock::now();
+            try {
+                ShaftBuilder builder;
+                builder.setFeaturePipeline(m_pipeline);
+                builder.buildFromProportions(proportions);
+                builder.build();
+            } catch (...) {
+                std::cout.rdbuf(previousOutput);
+                throw;
+            }
+            double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            seconds = attempt == 0 ? elapsed : std::min(seconds, elapsed);
+        }
+        std::cout.rdbuf(previousOutput);
+
+        ScalingSample sample = {segmentCount, proportions.getSlotCount(), seconds, 0.0};
+        if (!samples.empty() && samples.back().seconds > 0.0 && seconds > 0.0) {
+            const ScalingSample& previous = samples.back();
+            sample.exponent = std::log(seconds / previous.seconds) /
+                              std::log(static_cast<double>(segmentCount) / static_cast<double>(previous.segmentCount));
+        }
+        std::cout << segmentCount << " segments, " << sample.slotCount << " slots: " << seconds << " s ("
+                  << seconds / static_cast<double>(segmentCount) * 1000.0 << " ms per segment";
+        if (!samples.empty()) std::cout << ", growth exponent " << sample.exponent;
+        std::cout << ")" << std::endl;
+        samples.push_back(sample);
+    }
+    return samples;
+}
+
+double ScalingBenchmark::fitExponent(const std::vector<ScalingSample>& samples) {
+    double sumX = 0.0, sumY = 0.0, sumXX = 0.0, sumXY = 0.0;
+    size_t count = 0;
+    for (const ScalingSample& sample : samples) {
+        if (sample.seconds <= 0.0) continue;
+        const double x = std::log(static_cast<double>(sample.segmentCount));
+        const double y = std::log(sample.seconds);
+        sumX += x;
+        sumY += y;
+        sumXX += x * x;
+        sumXY += x * y;
+        ++count;
+    }
+    const double denominator = static_cast<double>(count) * sumXX - sumX * sumX;
+    if (count < 2 || denominator <= 0.0) throw std::invalid_argument("at least two distinct sizes are needed to fit growth");
+    return (static_cast<double>(count) * sumXY - sumX * sumY) / denominator;
+}
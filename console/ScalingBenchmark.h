@@ -0,0 +1,54 @@
+#ifndef SCALING_BENCHMARK_H
+#define SCALING_BENCHMARK_H
+
+#include "../lib/ShaftBuilder.h"
+#include <vector>
+#include <cstddef>
+
+/**
+ * @struct ScalingSample
+ * @brief Результат построения вала с заданным числом сегментов
+ */
+struct ScalingSample {
+    size_t segmentCount;   // Число сегментов
+    size_t slotCount;      // Число пазов
+    double seconds;        // Время построения, с
+    double exponent;       // Показатель роста времени относительно предыдущего размера (0 для первого)
+};
+
+/**
+ * @class ScalingBenchmark
+ * @brief Замер роста времени построения вала с числом сегментов и пазов
+ *
+ * Для каждого размера строится ступенчатый вал из повторяющихся участков
+ * (цилиндр с пазом, канавка, ступень, конус). Показатель роста - наклон кривой
+ * в логарифмических координатах; 1 соответствует линейному росту. Каждый размер
+ * строится несколько раз и берётся лучшее время, а общий показатель оценивается
+ * методом наименьших квадратов по всем размерам, чтобы шум малых валов не решал исход.
+ */
+class ScalingBenchmark {
+public:
+    explicit ScalingBenchmark(FeaturePipeline pipeline, int repeats = 3)
+        : m_pipeline(pipeline), m_repeats(repeats > 0 ? repeats : 1) {}
+
+    /**
+     * @brief Схема вала из segmentCount сегментов по 20 мм
+     */
+    static ShaftProportions makeSteppedShaft(size_t segmentCount);
+
+    /**
+     * @brief Построить валы всех размеров и замерить время
+     */
+    std::vector<ScalingSample> run(const std::vector<size_t>& segmentCounts) const;
+
+    /**
+     * @brief Показатель роста по всем замерам (наклон прямой в координатах log N, log t)
+     */
+    static double fitExponent(const std::vector<ScalingSample>& samples);
+
+private:
+    FeaturePipeline m_pipeline;
+    int m_repeats;
+};
+
+#endif // SCALING_BENCHMARK_H
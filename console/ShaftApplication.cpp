@@ -1,5 +1,19 @@
 #include "ShaftApplication.h"
+#include "BatchRunner.h"
+#include "ScalingBenchmark.h"
+#include "GoldenSuite.h"
+#include "StartupBenchmark.h"
+#include "../lib/ShaftDrawing.h"
+#include "../lib/ShaftAssembly.h"
+#include "../lib/ShaftFits.h"
+#include <BRep_Builder.hxx>
 #include <iostream>
+#include <sstream>
+#include <string>
+#include <chrono>
+#include <vector>
+#include <initializer_list>
+#include <stdexcept>
 
 /**
  * @brief Конструктор
@@ -33,10 +47,424 @@ void ShaftApplication::setTotalLength(double length) {
     core.setTotalLength(length);
 }
 
+/**
+ * @brief Задать уровень проверки геометрии перед экспортом
+ */
+void ShaftApplication::setCheckLevel(CheckLevel level) {
+    core.setCheckLevel(level);
+}
+
+/**
+ * @brief Задать допуск проверки роста допусков, мм
+ */
+void ShaftApplication::setToleranceLimit(double limit) {
+    core.setToleranceLimit(limit);
+}
+
+/**
+ * @brief Брать валы из файла-снимка и дописывать в него новые
+ */
+void ShaftApplication::setShapeCache(const std::string& filename) {
+    core.setShapeCache(filename);
+}
+
+/**
+ * @brief Время этапов последнего построения
+ */
+const RunTimings& ShaftApplication::getLastTimings() const {
+    return core.getLastTimings();
+}
+
+/**
+ * @brief Записать пакет одной STEP сборкой: каждый уникальный вал строится и записывается один раз
+ *
+ * Рабочие процессы строят только прототипы и возвращают их в BRep, экземпляры
+ * расставляются вдоль оси Y с шагом spacing.
+ */
+static bool exportBatchAssembly(const std::vector<BatchJob>& jobs, BatchOptions options,
+                                const std::string& assemblyFile, double spacing) {
+    ShaftAssembly assembly;
+    std::vector<BatchJob> prototypeJobs;
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        const BatchJob& job = jobs[i];
+        gp_Trsf placement;
+        placement.SetTranslation(gp_Vec(0.0, spacing * static_cast<double>(i), 0.0));
+        size_t prototype = assembly.addInstance(
+            job.name, ShaftProportions(job.totalLength, job.cylinder4Diameter, job.cylinder9Diameter, false), placement);
+        if (prototype == prototypeJobs.size()) prototypeJobs.push_back(job);
+    }
+    std::cout << jobs.size() << " shafts share " << prototypeJobs.size() << " unique geometries" << std::endl;
+
+    options.format = ExportFormat::BRep;
+    BatchRunner runner(options);
+    std::vector<BatchJobResult> results = runner.run(prototypeJobs,
+        [&assembly](size_t jobIndex, const char* data, size_t size, std::string& error) {
+            std::istringstream stream(std::string(data, size));
+            TopoDS_Shape shape;
+            BRep_Builder builder;
+            BRepTools::Read(shape, stream, builder);
+            if (shape.IsNull()) {
+                error = "cannot read BRep result";
+                return false;
+            }
+            assembly.setPrototypeShape(jobIndex, shape);
+            return true;
+        });
+
+    bool success = true;
+    for (size_t i = 0; i < prototypeJobs.size(); ++i) {
+        if (!results[i].success) {
+            std::cout << assembly.getPrototypes()[i].name << " (" << prototypeJobs[i].name << "): FAILED after "
+                      << results[i].attempts << " attempt(s): " << results[i].error << std::endl;
+            success = false;
+        }
+    }
+    return success && assembly.exportToSTEP(assemblyFile);
+}
+
+/**
+ * @brief Каталог посадок: встроенный ("default") или из файла
+ */
+static FitCatalogue loadFitCatalogue(const std::string& name) {
+    return name == "default" ? FitCatalogue::defaultCatalogue() : FitCatalogue::load(name);
+}
+
+/**
+ * @brief Проверить посадки вариантов, заданных заданиями пакета
+ *
+ * Проверка идёт в родительском процессе до запуска пула и поднимает потоки OSD_Parallel.
+ * Рабочие процессы после fork сразу заменяются execv, поэтому потоки пула и его
+ * блокировки в них не наследуются.
+ */
+static FitReport checkJobFits(const std::vector<BatchJob>& jobs, const FitCatalogue& catalogue) {
+    std::vector<ShaftProportions> variants;
+    variants.reserve(jobs.size());
+    for (const BatchJob& job : jobs) {
+        variants.emplace_back(job.totalLength, job.cylinder4Diameter, job.cylinder9Diameter, false);
+    }
+    return FitChecker(catalogue).check(variants);
+}
+
+/**
+ * @brief Значение ключа из списка допустимых; опечатка не должна молча давать значение по умолчанию
+ */
+static std::string checkChoice(const std::string& option, const std::string& value,
+                               std::initializer_list<const char*> choices) {
+    for (const char* choice : choices) {
+        if (value == choice) return value;
+    }
+    throw std::invalid_argument("invalid value '" + value + "' for " + option);
+}
+
+static void printBatchUsage() {
+    std::cerr << "Usage: Console --batch <jobs file> [--workers N] [--timeout seconds] [--memory MB]"
+              << " [--retries N] [--payload MB] [--format step|brep] [--pipeline global|local]"
+              << " [--check none|fast|standard|full] [--compact on|off] [--fits catalogue|default] [--drawings directory] [--drawing-format svg|dxf] [--assembly file.step] [--spacing mm]"
+              << std::endl;
+}
+
+/**
+ * @brief Пакетное построение: Console --batch <файл заданий> [параметры пула]
+ */
+static int runBatch(int argc, char *argv[]) {
+    if (argc < 3) {
+        printBatchUsage();
+        return 1;
+    }
+    BatchOptions options;
+    std::string drawingDirectory;
+    std::string drawingExtension = ".svg";
+    std::string assemblyFile;
+    std::string fitCatalogue;
+    double spacing = 60.0;
+    try {
+        for (int i = 3; i < argc; ++i) {
+            std::string option = argv[i];
+            if (i + 1 >= argc) throw std::invalid_argument("missing value for " + option);
+            std::string value = argv[++i];
+            if (option == "--workers") options.workerCount = std::stoi(value);
+            else if (option == "--timeout") options.jobTimeoutSeconds = std::stod(value);
+            else if (option == "--memory") options.memoryLimitMb = std::stoul(value);
+            else if (option == "--retries") options.maxRetries = std::stoi(value);
+            else if (option == "--payload") options.payloadCapacityMb = std::stoul(value);
+            else if (option == "--format") options.format = checkChoice(option, value, {"step", "brep"}) == "brep" ? ExportFormat::BRep : ExportFormat::STEP;
+            else if (option == "--pipeline") options.pipeline = checkChoice(option, value, {"global", "local"}) == "local" ? FeaturePipeline::SegmentLocal : FeaturePipeline::Global;
+            else if (option == "--check") options.checkLevel = ShaftValidator::parseLevel(value);
+            else if (option == "--compact") options.compaction = checkChoice(option, value, {"on", "off"}) == "on";
+            else if (option == "--fits") fitCatalogue = value;
+            else if (option == "--drawings") drawingDirectory = value;
+            else if (option == "--drawing-format") drawingExtension = checkChoice(option, value, {"svg", "dxf"}) == "dxf" ? ".dxf" : ".svg";
+            else if (option == "--assembly") assemblyFile = value;
+            else if (option == "--spacing") spacing = std::stod(value);
+            else throw std::invalid_argument("unknown option " + option);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        printBatchUsage();
+        return 1;
+    }
+
+    std::vector<BatchJob> jobs;
+    try {
+        jobs = BatchRunner::loadJobs(argv[2], options.format);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    std::cout << "Batch of " << jobs.size() << " jobs loaded from " << argv[2] << std::endl;
+
+    size_t rejected = 0;
+    if (!fitCatalogue.empty()) {
+        // Варианты с нарушенными посадками отбрасываются до построения
+        FitReport fits;
+        try {
+            fits = checkJobFits(jobs, loadFitCatalogue(fitCatalogue));
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        std::vector<std::string> names;
+        for (const BatchJob& job : jobs) names.push_back(job.name);
+        fits.print(std::cout, names);
+        std::vector<BatchJob> accepted;
+        for (size_t i = 0; i < jobs.size(); ++i) {
+            if (fits.isValid(i)) accepted.push_back(jobs[i]);
+        }
+        rejected = jobs.size() - accepted.size();
+        jobs.swap(accepted);
+        std::cout << rejected << " jobs rejected by the fit check" << std::endl;
+        if (jobs.empty()) return 1;
+    }
+
+    if (!drawingDirectory.empty()) {
+        // Чертежи строятся аналитически в родительском процессе, B-rep для них не нужен
+        size_t drawn = 0;
+        for (const BatchJob& job : jobs) {
+            ShaftReadout readout = ShaftAnalysis::analyze(job.totalLength, job.cylinder4Diameter, job.cylinder9Diameter);
+            if (!readout.isValid()) {
+                std::cout << job.name << ": no drawing, " << readout.violations.front() << std::endl;
+                continue;
+            }
+            if (ShaftDrawing(readout).save(drawingDirectory + "/" + job.name + drawingExtension)) ++drawn;
+        }
+        std::cout << drawn << " of " << jobs.size() << " drawings written to " << drawingDirectory << std::endl;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    if (!assemblyFile.empty()) {
+        bool success = exportBatchAssembly(jobs, options, assemblyFile, spacing);
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "Batch assembly " << (success ? "finished" : "FAILED") << " in " << elapsed << " s" << std::endl;
+        return success && rejected == 0 ? 0 : 1;
+    }
+
+    BatchRunner runner(options);
+    std::vector<BatchJobResult> results = runner.run(jobs);
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    size_t succeeded = 0;
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        const BatchJobResult& result = results[i];
+        if (result.success) {
+            ++succeeded;
+            std::cout << jobs[i].name << ": ok, " << result.payloadSize << " bytes -> " << jobs[i].outputFile
+                      << " (" << result.seconds << " s, attempts " << result.attempts << ")" << std::endl;
+        } else {
+            std::cout << jobs[i].name << ": FAILED after " << result.attempts << " attempt(s): "
+                      << result.error << std::endl;
+        }
+    }
+    std::cout << "Batch finished: " << succeeded << " of " << jobs.size() << " jobs succeeded in "
+              << elapsed << " s" << std::endl;
+    return succeeded == jobs.size() && rejected == 0 ? 0 : 1;
+}
+
+/**
+ * @brief Замер масштабируемости: Console --bench-scaling [--pipeline global|local] [--max-exponent X] [--repeats R] [N ...]
+ *
+ * Возвращает ненулевой код, если время построения, оценённое по всем размерам, растёт быстрее, чем N^X.
+ */
+static int runScalingBenchmark(int argc, char *argv[]) {
+    FeaturePipeline pipeline = FeaturePipeline::SegmentLocal;
+    double maxExponent = 1.3;
+    int repeats = 3;
+    std::vector<size_t> segmentCounts;
+    try {
+        for (int i = 2; i < argc; ++i) {
+            std::string option = argv[i];
+            if (option == "--pipeline" && i + 1 < argc) {
+                pipeline = checkChoice(option, argv[++i], {"global", "local"}) == "global" ? FeaturePipeline::Global : FeaturePipeline::SegmentLocal;
+            } else if (option == "--max-exponent" && i + 1 < argc) {
+                maxExponent = std::stod(argv[++i]);
+            } else if (option == "--repeats" && i + 1 < argc) {
+                repeats = std::stoi(argv[++i]);
+            } else {
+                segmentCounts.push_back(std::stoul(option));
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: invalid benchmark arguments: " << e.what() << std::endl;
+        return 1;
+    }
+    // Малые валы строятся за миллисекунды, их время определяется шумом, а не ростом
+    if (segmentCounts.empty()) segmentCounts = {100, 300, 1000};
+
+    double exponent = 0.0;
+    try {
+        exponent = ScalingBenchmark::fitExponent(ScalingBenchmark(pipeline, repeats).run(segmentCounts));
+    } catch (const std::exception& e) {
+        std::cerr << "Error during scaling benchmark: " << e.what() << std::endl;
+        return 1;
+    }
+
+    if (exponent > maxExponent) {
+        std::cerr << "Error: build time grows as N^" << exponent << ", limit is N^" << maxExponent << std::endl;
+        return 1;
+    }
+    std::cout << "Build time grows as N^" << exponent << ", within limit N^" << maxExponent << std::endl;
+    return 0;
+}
+
+/**
+ * @brief Чертёж вала: Console --drawing <файл.svg|файл.dxf> [длина d4 d9]
+ */
+static int runDrawing(int argc, char *argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: Console --drawing <file.svg|file.dxf> [total length] [d4] [d9]" << std::endl;
+        return 1;
+    }
+    double totalLength = 230.0;
+    double cylinder4Diameter = 23.0;
+    double cylinder9Diameter = 27.0;
+    try {
+        if (argc > 3) totalLength = std::stod(argv[3]);
+        if (argc > 4) cylinder4Diameter = std::stod(argv[4]);
+        if (argc > 5) cylinder9Diameter = std::stod(argv[5]);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: invalid drawing arguments: " << e.what() << std::endl;
+        return 1;
+    }
+
+    ShaftReadout readout = ShaftAnalysis::analyze(totalLength, cylinder4Diameter, cylinder9Diameter);
+    if (!readout.isValid()) {
+        for (const std::string& violation : readout.violations) {
+            std::cerr << "Error: " << violation << std::endl;
+        }
+        return 1;
+    }
+    return ShaftDrawing(readout).save(argv[2]) ? 0 : 1;
+}
+
+/**
+ * @brief Эталонные сигнатуры: Console --golden record|verify <файл>
+ */
+static int runGolden(int argc, char *argv[]) {
+    std::string mode = argc > 2 ? argv[2] : "";
+    if (argc < 4 || (mode != "record" && mode != "verify")) {
+        std::cerr << "Usage: Console --golden record|verify <signatures file>" << std::endl;
+        return 1;
+    }
+    try {
+        return mode == "record" ? GoldenSuite::record(argv[3]) : GoldenSuite::verify(argv[3]);
+    } catch (const std::exception& e) {
+        std::cerr << "Error during golden check: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+/**
+ * @brief Проверка посадок: Console --fits <каталог|default> [файл заданий]
+ *
+ * Без файла заданий проверяется вал со стандартными размерами.
+ */
+static int runFits(int argc, char *argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: Console --fits <catalogue file|default> [jobs file]" << std::endl;
+        return 1;
+    }
+    try {
+        FitCatalogue catalogue = loadFitCatalogue(argv[2]);
+        std::vector<BatchJob> jobs;
+        if (argc > 3) jobs = BatchRunner::loadJobs(argv[3], ExportFormat::STEP);
+        else jobs.push_back(BatchJob{"default", 230.0, 23.0, 27.0, std::string()});
+        std::vector<std::string> names;
+        for (const BatchJob& job : jobs) names.push_back(job.name);
+        FitReport report = checkJobFits(jobs, catalogue);
+        report.print(std::cout, names, argc <= 3);
+        return report.validCount() == jobs.size() ? 0 : 1;
+    } catch (const std::exception& e) {
+        std::cerr << "Error during fit check: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+/**
+ * @brief Замер холодного запуска: Console --bench-startup [N] [--max-ms X]
+ *
+ * Возвращает ненулевой код, если среднее время запуска превышает X мс.
+ */
+static int runStartupBenchmark(int argc, char *argv[]) {
+    int launchCount = 20;
+    double maxMilliseconds = 0.0;
+    try {
+        for (int i = 2; i < argc; ++i) {
+            std::string option = argv[i];
+            if (option == "--max-ms" && i + 1 < argc) maxMilliseconds = std::stod(argv[++i]);
+            else launchCount = std::stoi(option);
+        }
+        StartupSample sample = StartupBenchmark(StartupBenchmark::currentExecutable(argv[0])).run(launchCount);
+        if (maxMilliseconds > 0.0 && sample.meanSeconds * 1000.0 > maxMilliseconds) {
+            std::cerr << "Error: mean startup time " << sample.meanSeconds * 1000.0 << " ms exceeds the limit of "
+                      << maxMilliseconds << " ms" << std::endl;
+            return 1;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error during startup benchmark: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
 /**
  * @brief Главная функция
  */
 int main(int argc, char *argv[]) {
+    // Проба для замера запуска: всё, что дорого при старте, уже выполнено до main
+    if (argc > 1 && std::string(argv[1]) == "--startup-probe") return 0;
+    const double startupSeconds = StartupBenchmark::processUptimeSeconds();
+    const auto mainStart = std::chrono::steady_clock::now();
+
+    if (argc > 1 && std::string(argv[1]) == "--worker") return BatchRunner::workerMain(argc, argv);
+    if (argc > 1 && std::string(argv[1]) == "--batch") return runBatch(argc, argv);
+    if (argc > 1 && std::string(argv[1]) == "--bench-scaling") return runScalingBenchmark(argc, argv);
+    if (argc > 1 && std::string(argv[1]) == "--drawing") return runDrawing(argc, argv);
+    if (argc > 1 && std::string(argv[1]) == "--golden") return runGolden(argc, argv);
+    if (argc > 1 && std::string(argv[1]) == "--bench-startup") return runStartupBenchmark(argc, argv);
+    if (argc > 1 && std::string(argv[1]) == "--fits") return runFits(argc, argv);
+
+    // Параметры вала задаются позиционно, ключи --cache, --check и --tolerance-limit можно указать
+    // в любом месте. Проверка по умолчанию выключена: она необязательна и удлиняет запуск
+    std::vector<std::string> positional;
+    std::string cacheFile;
+    CheckLevel checkLevel = CheckLevel::None;
+    double toleranceLimit = ShaftValidator::defaultToleranceLimit;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string argument = argv[i];
+            if (argument == "--cache" && i + 1 < argc) cacheFile = argv[++i];
+            else if (argument == "--check" && i + 1 < argc) checkLevel = ShaftValidator::parseLevel(argv[++i]);
+            else if (argument == "--tolerance-limit" && i + 1 < argc) toleranceLimit = std::stod(argv[++i]);
+            else positional.push_back(argument);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: invalid option value: " << e.what() << std::endl;
+        return 1;
+    }
+    if (!(toleranceLimit > 0.0)) {
+        std::cerr << "Error: --tolerance-limit must be positive." << std::endl;
+        return 1;
+    }
+
     double totalLength = 230.0;
     double cylinder4Diameter = 23.0;
     double cylinder9Diameter = 27.0;
@@ -65,9 +493,9 @@ int main(int argc, char *argv[]) {
             return 1;
         }
     } else {
-        if (argc > 1) totalLength = std::stod(argv[1]);
-        if (argc > 2) cylinder4Diameter = std::stod(argv[2]);
-        if (argc > 3) cylinder9Diameter = std::stod(argv[3]);
+        if (positional.size() > 0) totalLength = std::stod(positional[0]);
+        if (positional.size() > 1) cylinder4Diameter = std::stod(positional[1]);
+        if (positional.size() > 2) cylinder9Diameter = std::stod(positional[2]);
 
         if (totalLength <= 200 || totalLength >= 300 ||
             cylinder4Diameter <= 20 || cylinder4Diameter >= 35 ||
@@ -83,5 +511,15 @@ int main(int argc, char *argv[]) {
     std::cout << "Diameter of the 9th cylinder: " << cylinder9Diameter << " mm" << std::endl;
 
     ShaftApplication app(totalLength, cylinder4Diameter, cylinder9Diameter, chamferLength, chamferAngle);
-    return app.run("shaft_custom_dimensions.step");
+    app.setCheckLevel(checkLevel);
+    app.setToleranceLimit(toleranceLimit);
+    if (!cacheFile.empty()) app.setShapeCache(cacheFile);
+    const double setupSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - mainStart).count();
+    int result = app.run("shaft_custom_dimensions.step");
+
+    const RunTimings& timings = app.getLastTimings();
+    std::cout << "Time breakdown: startup " << startupSeconds << " s, setup " << setupSeconds << " s, build "
+              << timings.buildSeconds << " s" << (timings.fromCache ? " (cached)" : "") << ", export "
+              << timings.exportSeconds << " s" << std::endl;
+    return result;
 }
@@ -23,6 +23,10 @@ public:
     int run(const std::string& exportFilename = "shaft.step");
     void setSegmentDiameter(int segmentIndex, double diameter);
     void setTotalLength(double length);
+    void setCheckLevel(CheckLevel level);
+    void setToleranceLimit(double limit);
+    void setShapeCache(const std::string& filename);
+    const RunTimings& getLastTimings() const;
 };
 
 #endif // SHAFT_APPLICATION_H
@@ -0,0 +1,121 @@
+#include "StartupBenchmark.h"
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <unistd.h>
+#include <sys/wait.h>
+#include <climits>
+#endif
+
+StartupSample StartupBenchmark::run(int launchCount) const {
+    if (launchCount <= 0) throw std::invalid_argument("launch count must be positive");
+    // Первый запуск прогревает файловый кэш системы и в замер не входит
+    if (launch({"--startup-probe"}) < 0.0) {
+        throw std::runtime_error("cannot launch " + m_executable);
+    }
+    StartupSample sample = {"startup probe", 0.0, 0.0};
+    double total = 0.0;
+    for (int i = 0; i < launchCount; ++i) {
+        double seconds = launch({"--startup-probe"});
+        if (seconds < 0.0) throw std::runtime_error("startup probe failed");
+        sample.minSeconds = i == 0 ? seconds : std::min(sample.minSeconds, seconds);
+        total += seconds;
+    }
+    sample.meanSeconds = total / launchCount;
+    std::cout << sample.mode << ": " << launchCount << " launches, min " << sample.minSeconds * 1000.0
+              << " ms, mean " << sample.meanSeconds * 1000.0 << " ms" << std::endl;
+    return sample;
+}
+
+double StartupBenchmark::processUptimeSeconds() {
+#ifdef _WIN32
+    FILETIME creation, exitTime, kernel, user, now;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exitTime, &kernel, &user)) return 0.0;
+    GetSystemTimeAsFileTime(&now);
+    ULARGE_INTEGER start, current;
+    start.LowPart = creation.dwLowDateTime;
+    start.HighPart = creation.dwHighDateTime;
+    current.LowPart = now.dwLowDateTime;
+    current.HighPart = now.dwHighDateTime;
+    return static_cast<double>(current.QuadPart - start.QuadPart) / 1e7;
+#elif defined(__linux__)
+    // Поле 22 (starttime) - момент старта в тактах от загрузки системы; имя процесса в скобках
+    // может содержать пробелы, поэтому поля отсчитываются от последней закрывающей скобки
+    std::ifstream input("/proc/self/stat");
+    std::string stat;
+    if (!std::getline(input, stat)) return 0.0;
+    const size_t nameEnd = stat.rfind(')');
+    if (nameEnd == std::string::npos) return 0.0;
+    std::istringstream fields(stat.substr(nameEnd + 1));
+    std::string field;
+    for (int i = 3; i < 22 && fields >> field; ++i) {}
+    unsigned long long startTicks = 0;
+    const long ticksPerSecond = sysconf(_SC_CLK_TCK);
+    timespec now;
+    if (!(fields >> startTicks) || ticksPerSecond <= 0 || clock_gettime(CLOCK_BOOTTIME, &now) != 0) return 0.0;
+    const double uptime = static_cast<double>(now.tv_sec) + static_cast<double>(now.tv_nsec) / 1e9 -
+                          static_cast<double>(startTicks) / static_cast<double>(ticksPerSecond);
+    return std::max(uptime, 0.0);
+#else
+    return 0.0;
+#endif
+}
+
+std::string StartupBenchmark::currentExecutable(const char* argv0) {
+#ifdef _WIN32
+    char path[MAX_PATH];
+    DWORD length = GetModuleFileNameA(nullptr, path, MAX_PATH);
+    if (length > 0 && length < MAX_PATH) return std::string(path, length);
+#else
+    char path[PATH_MAX];
+    ssize_t length = readlink("/proc/self/exe", path, sizeof(path));
+    if (length > 0 && static_cast<size_t>(length) < sizeof(path)) return std::string(path, static_cast<size_t>(length));
+#endif
+    return argv0 ? argv0 : "";
+}
+
+double StartupBenchmark::launch(const std::vector<std::string>& arguments) const {
+    auto start = std::chrono::steady_clock::now();
+#ifdef _WIN32
+    std::string commandLine = '"' + m_executable + '"';
+    for (const std::string& argument : arguments) commandLine += ' ' + argument;
+    STARTUPINFOA startup = {};
+    startup.cb = sizeof(startup);
+    PROCESS_INFORMATION process = {};
+    if (!CreateProcessA(nullptr, &commandLine[0], nullptr, nullptr, FALSE, 0, nullptr, nullptr, &startup, &process)) {
+        return -1.0;
+    }
+    WaitForSingleObject(process.hProcess, INFINITE);
+    DWORD exitCode = 1;
+    GetExitCodeProcess(process.hProcess, &exitCode);
+    CloseHandle(process.hThread);
+    CloseHandle(process.hProcess);
+    if (exitCode != 0) return -1.0;
+#else
+    std::vector<char*> argv;
+    argv.push_back(const_cast<char*>(m_executable.c_str()));
+    for (const std::string& argument : arguments) argv.push_back(const_cast<char*>(argument.c_str()));
+    argv.push_back(nullptr);
+    pid_t pid = fork();
+    if (pid < 0) return -1.0;
+    if (pid == 0) {
+        execv(m_executable.c_str(), argv.data());
+        _exit(127);
+    }
+    int status = 0;
+    if (waitpid(pid, &status, 0) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0) return -1.0;
+#endif
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
@@ -0,0 +1,61 @@
+#ifndef STARTUP_BENCHMARK_H
+#define STARTUP_BENCHMARK_H
+
+#include <string>
+#include <vector>
+
+/**
+ * @struct StartupSample
+ * @brief Время запусков Console в одном режиме
+ */
+struct StartupSample {
+    std::string mode;       // Описание режима
+    double minSeconds;      // Лучшее время запуска, с
+    double meanSeconds;     // Среднее время запуска, с
+};
+
+/**
+ * @class StartupBenchmark
+ * @brief Замер времени холодного запуска Console
+ *
+ * Console запускается отдельным процессом с ключом --startup-probe, который завершает
+ * работу сразу после входа в main: замер включает загрузку исполняемого файла,
+ * библиотек и статическую инициализацию, но не построение.
+ */
+class StartupBenchmark {
+public:
+    /**
+     * @param executable Путь к Console
+     */
+    explicit StartupBenchmark(const std::string& executable) : m_executable(executable) {}
+
+    /**
+     * @brief Запустить Console launchCount раз с ключом --startup-probe
+     */
+    StartupSample run(int launchCount) const;
+
+    /**
+     * @brief Время от создания процесса до вызова функции, с
+     *
+     * В Windows - по времени создания процесса, в Linux - по времени старта из /proc/self/stat
+     * относительно CLOCK_BOOTTIME (точность - такт планировщика, обычно 10 мс). В остальных
+     * системах время недоступно и возвращается 0.
+     */
+    static double processUptimeSeconds();
+
+    /**
+     * @brief Путь к исполняемому файлу текущего процесса
+     */
+    static std::string currentExecutable(const char* argv0);
+
+private:
+    /**
+     * @brief Запустить процесс и дождаться его завершения
+     * @return Время работы процесса, с, или отрицательное значение при ошибке
+     */
+    double launch(const std::vector<std::string>& arguments) const;
+
+    std::string m_executable;
+};
+
+#endif // STARTUP_BENCHMARK_H
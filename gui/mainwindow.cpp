@@ -5,10 +5,27 @@
 #include <QPushButton>
 #include <QFileDialog>
 #include <QMessageBox>
+#include <QSlider>
+#include <QTimer>
+#include <QTableWidget>
+#include <QHeaderView>
+#include <QSignalBlocker>
+#include <QHBoxLayout>
+#include <QKeySequence>
+#include <cmath>
+
+// Задержка пересчёта после ввода, мс: пересчёт выполняется один раз после серии изменений
+static const int readoutDelayMs = 50;
+// Пауза во вводе, после которой параметры фиксируются снимком для отмены, мс
+static const int snapshotDelayMs = 600;
+// Шаг ползунков, мм
+static const double sliderStep = 0.1;
 
 MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), core(230.0, 23.0, 27.0, 0.025, 45.0) {
     setWindowTitle("Shaft Builder");
-    resize(400, 300);
+    resize(560, 720);
+    // Проверка геометрии необязательна и по умолчанию выключена, как и в консоли
+    core.setCheckLevel(CheckLevel::None);
 
     QWidget *centralWidget = new QWidget(this);
     setCentralWidget(centralWidget);
@@ -29,14 +46,185 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), core(230.0, 23.0,
     cylinder9DiameterEdit = new QLineEdit("27.0", this);
     layout->addWidget(cylinder9DiameterEdit);
 
+    // Ползунки для быстрого подбора параметров
+    layout->insertWidget(layout->indexOf(totalLengthEdit) + 1, addParameterSlider(totalLengthEdit, 200.0, 300.0));
+    layout->insertWidget(layout->indexOf(cylinder4DiameterEdit) + 1, addParameterSlider(cylinder4DiameterEdit, 20.0, 35.0));
+    layout->insertWidget(layout->indexOf(cylinder9DiameterEdit) + 1, addParameterSlider(cylinder9DiameterEdit, 20.0, 35.0));
+
+    // Аналитические показатели, пересчитываемые без построения модели
+    summaryLabel = new QLabel(this);
+    layout->addWidget(summaryLabel);
+    slotLabel = new QLabel(this);
+    layout->addWidget(slotLabel);
+    violationLabel = new QLabel(this);
+    violationLabel->setStyleSheet("color: #b00020;");
+    violationLabel->setWordWrap(true);
+    layout->addWidget(violationLabel);
+
+    segmentTable = new QTableWidget(0, 5, this);
+    segmentTable->setHorizontalHeaderLabels({"Segment", "Z start", "Length", "Diameter", "End diameter"});
+    segmentTable->verticalHeader()->setVisible(false);
+    segmentTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    segmentTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    layout->addWidget(segmentTable, 1);
+
+    // Кнопки отмены и повтора правок
+    QHBoxLayout *historyLayout = new QHBoxLayout;
+    undoButton = new QPushButton("Undo", this);
+    undoButton->setShortcut(QKeySequence::Undo);
+    redoButton = new QPushButton("Redo", this);
+    redoButton->setShortcut(QKeySequence::Redo);
+    historyLayout->addWidget(undoButton);
+    historyLayout->addWidget(redoButton);
+    layout->addLayout(historyLayout);
+
     // Кнопка "Построить"
     buildButton = new QPushButton("Build", this);
     layout->addWidget(buildButton);
 
-    layout->addStretch();
+    readoutTimer = new QTimer(this);
+    readoutTimer->setSingleShot(true);
+    readoutTimer->setInterval(readoutDelayMs);
+    snapshotTimer = new QTimer(this);
+    snapshotTimer->setSingleShot(true);
+    snapshotTimer->setInterval(snapshotDelayMs);
 
-    // Подключение сигнала кнопки
+    // Подключение сигналов
     connect(buildButton, &QPushButton::clicked, this, &MainWindow::onBuildButtonClicked);
+    connect(undoButton, &QPushButton::clicked, this, &MainWindow::onUndoClicked);
+    connect(redoButton, &QPushButton::clicked, this, &MainWindow::onRedoClicked);
+    connect(readoutTimer, &QTimer::timeout, this, &MainWindow::updateReadouts);
+    connect(snapshotTimer, &QTimer::timeout, this, [this]() {
+        core.commitSnapshot();
+        updateHistoryButtons();
+    });
+    for (QLineEdit *edit : {totalLengthEdit, cylinder4DiameterEdit, cylinder9DiameterEdit}) {
+        connect(edit, &QLineEdit::textChanged, this, &MainWindow::onParametersChanged);
+    }
+
+    updateReadouts();
+    updateHistoryButtons();
+}
+
+QSlider *MainWindow::addParameterSlider(QLineEdit *edit, double minimum, double maximum) {
+    QSlider *slider = new QSlider(Qt::Horizontal, this);
+    // Границы диапазона сами недопустимы, ползунок останавливается на шаг внутри
+    slider->setRange(static_cast<int>(std::lround(minimum / sliderStep)) + 1, static_cast<int>(std::lround(maximum / sliderStep)) - 1);
+    slider->setValue(static_cast<int>(std::lround(edit->text().toDouble() / sliderStep)));
+
+    // Ползунок и поле ввода синхронизируются без повторного срабатывания друг друга
+    connect(slider, &QSlider::valueChanged, this, [edit](int value) {
+        edit->setText(QString::number(value * sliderStep, 'f', 1));
+    });
+    connect(edit, &QLineEdit::textChanged, this, [slider](const QString &text) {
+        bool ok;
+        double value = text.toDouble(&ok);
+        if (!ok) return;
+        QSignalBlocker blocker(slider);
+        slider->setValue(static_cast<int>(std::lround(value / sliderStep)));
+    });
+    return slider;
+}
+
+void MainWindow::onParametersChanged() {
+    // Таймер перезапускается при каждом изменении, пересчёт выполняется после паузы во вводе
+    readoutTimer->start();
+    snapshotTimer->start();
+    // Отмена доступна сразу, не дожидаясь фиксации снимка по таймеру
+    updateHistoryButtons();
+}
+
+void MainWindow::updateReadouts() {
+    bool lengthOk, diameter4Ok, diameter9Ok;
+    double totalLength = totalLengthEdit->text().toDouble(&lengthOk);
+    double cylinder4Diameter = cylinder4DiameterEdit->text().toDouble(&diameter4Ok);
+    double cylinder9Diameter = cylinder9DiameterEdit->text().toDouble(&diameter9Ok);
+    if (!lengthOk || !diameter4Ok || !diameter9Ok) {
+        ShaftReadout readout;
+        readout.violations.push_back("All parameters must be numbers");
+        showReadout(readout);
+        return;
+    }
+    ShaftReadout readout = ShaftAnalysis::analyze(totalLength, cylinder4Diameter, cylinder9Diameter);
+    showReadout(readout);
+    if (readout.isValid()) applyParameters(totalLength, cylinder4Diameter, cylinder9Diameter);
+}
+
+void MainWindow::applyParameters(double totalLength, double cylinder4Diameter, double cylinder9Diameter) {
+    // В ядро передаются только изменившиеся значения, чтобы не создавать пустых снимков
+    const ShaftProportions &current = core.getProportions();
+    if (current.getTotalLength() != totalLength) core.setTotalLength(totalLength);
+    if (current.getSegmentDiameter(3) != cylinder4Diameter) core.setSegmentDiameter(3, cylinder4Diameter);
+    if (current.getSegmentDiameter(9) != cylinder9Diameter) core.setSegmentDiameter(9, cylinder9Diameter);
+}
+
+void MainWindow::onUndoClicked() {
+    if (core.undo()) loadParametersFromCore();
+    updateHistoryButtons();
+}
+
+void MainWindow::onRedoClicked() {
+    if (core.redo()) loadParametersFromCore();
+    updateHistoryButtons();
+}
+
+void MainWindow::loadParametersFromCore() {
+    const ShaftProportions &proportions = core.getProportions();
+    totalLengthEdit->setText(QString::number(proportions.getTotalLength(), 'g', 15));
+    cylinder4DiameterEdit->setText(QString::number(proportions.getSegmentDiameter(3), 'g', 15));
+    cylinder9DiameterEdit->setText(QString::number(proportions.getSegmentDiameter(9), 'g', 15));
+}
+
+void MainWindow::updateHistoryButtons() {
+    undoButton->setEnabled(core.getHistory().canUndo() || snapshotTimer->isActive());
+    redoButton->setEnabled(core.getHistory().canRedo());
+}
+
+void MainWindow::showReadout(const ShaftReadout &readout) {
+    summaryLabel->setText(QString("Base diameter: %1 mm    Length: %2 mm    Volume: %3 cm%5    Mass: %4 kg")
+                              .arg(readout.baseDiameter, 0, 'f', 2)
+                              .arg(readout.totalLength, 0, 'f', 2)
+                              .arg(readout.volume / 1000.0, 0, 'f', 2)
+                              .arg(readout.mass, 0, 'f', 3)
+                              .arg(QChar(0x00B3)));
+
+    QStringList slotLines;
+    for (const SlotReadout &slot : readout.slotDetails) {
+        slotLines << QString("Slot on %1: %2 x %3 x %4 mm at Z=%5")
+                     .arg(QString::fromStdString(readout.segments[slot.segmentIndex].name))
+                     .arg(slot.width, 0, 'f', 2)
+                     .arg(slot.depth, 0, 'f', 2)
+                     .arg(slot.length, 0, 'f', 2)
+                     .arg(slot.zStart, 0, 'f', 2);
+    }
+    slotLabel->setText(slotLines.join("\n"));
+
+    QStringList violations;
+    for (const std::string &violation : readout.violations) violations << QString::fromStdString(violation);
+    violationLabel->setText(violations.join("\n"));
+    violationLabel->setVisible(!violations.isEmpty());
+
+    // Строки таблицы переиспользуются, чтобы обновление не пересоздавало виджеты
+    const int rows = static_cast<int>(readout.segments.size());
+    segmentTable->setRowCount(rows);
+    for (int row = 0; row < rows; ++row) {
+        const SegmentReadout &segment = readout.segments[row];
+        QStringList cells = {
+            QString::fromStdString(segment.name) + (segment.reduced ? " (reduced)" : ""),
+            QString::number(segment.zStart, 'f', 2),
+            QString::number(segment.length, 'f', 2),
+            QString::number(segment.diameter, 'f', 2),
+            segment.type == "cone" ? QString::number(segment.diameterEnd, 'f', 2) : QString()
+        };
+        for (int column = 0; column < cells.size(); ++column) {
+            QTableWidgetItem *item = segmentTable->item(row, column);
+            if (!item) {
+                item = new QTableWidgetItem;
+                segmentTable->setItem(row, column, item);
+            }
+            item->setText(cells[column]);
+        }
+    }
 }
 
 void MainWindow::onBuildButtonClicked() {
@@ -3,9 +3,14 @@
 
 #include <QMainWindow>
 #include "../lib/ShaftAppCore.h"
+#include "../lib/ShaftAnalysis.h"
 
 class QLineEdit;
 class QPushButton;
+class QSlider;
+class QLabel;
+class QTableWidget;
+class QTimer;
 
 class MainWindow : public QMainWindow {
     Q_OBJECT
@@ -15,13 +20,31 @@ public:
 
 private slots:
     void onBuildButtonClicked();
+    void onParametersChanged();
+    void updateReadouts();
+    void onUndoClicked();
+    void onRedoClicked();
 
 private:
+    QSlider *addParameterSlider(QLineEdit *edit, double minimum, double maximum);
+    void showReadout(const ShaftReadout &readout);
+    void applyParameters(double totalLength, double cylinder4Diameter, double cylinder9Diameter);
+    void loadParametersFromCore();
+    void updateHistoryButtons();
+
     ShaftAppCore core;
     QLineEdit *totalLengthEdit;
     QLineEdit *cylinder4DiameterEdit;
     QLineEdit *cylinder9DiameterEdit;
     QPushButton *buildButton;
+    QPushButton *undoButton;
+    QPushButton *redoButton;
+    QTimer *readoutTimer;
+    QTimer *snapshotTimer;
+    QTableWidget *segmentTable;
+    QLabel *summaryLabel;
+    QLabel *slotLabel;
+    QLabel *violationLabel;
 };
 
 #endif // MAIN_WINDOW_H
@@ -0,0 +1,259 @@
+/**
+ * @file ShaftAnalysis.h
+ * @brief Аналитический расчёт размеров, массы и ограничений вала без построения B-rep
+ */
+
+#ifndef SHAFT_ANALYSIS_H
+#define SHAFT_ANALYSIS_H
+
+#include "ShaftProportions.h"
+#include <vector>
+#include <string>
+#include <sstream>
+#include <cmath>
+#include <algorithm>
+
+/**
+ * @struct SegmentReadout
+ * @brief Размеры сегмента в том виде, в котором его строит ShaftBuilder
+ */
+struct SegmentReadout {
+    std::string name;
+    std::string type;
+    double zStart;
+    double length;
+    double diameter;     // Диаметр с учётом уменьшения под канавку
+    double diameterEnd;  // Конечный диаметр конуса (0 для цилиндра)
+    bool reduced;
+
+    double zEnd() const { return zStart + length; }
+};
+
+/**
+ * @struct SlotReadout
+ * @brief Размеры паза в том виде, в котором его вырезает ShaftBuilder
+ */
+struct SlotReadout {
+    int segmentIndex;
+    double width;
+    double depth;
+    double length;       // Длина прямого участка после ограничения границей сегмента
+    double zStart;
+    double hostDiameter; // Диаметр сегмента, на котором лежит паз
+};
+
+/**
+ * @struct ShaftReadout
+ * @brief Производные величины вала и найденные нарушения ограничений
+ */
+struct ShaftReadout {
+    std::vector<SegmentReadout> segments;
+    std::vector<SlotReadout> slotDetails;
+    double baseDiameter = 0.0;
+    double totalLength = 0.0;   // Фактическая длина с учётом припусков под фаски
+    double chamferLength = 0.0;
+    double volume = 0.0;        // мм³
+    double mass = 0.0;          // кг
+    std::vector<std::string> violations;
+
+    bool isValid() const { return violations.empty(); }
+};
+
+/**
+ * @class ShaftAnalysis
+ * @brief Расчёт ShaftReadout по ShaftProportions, повторяющий правила ShaftBuilder::buildFromProportions
+ */
+class ShaftAnalysis {
+public:
+    static constexpr double steelDensity = 7.85e-6;    // кг/мм³
+    static constexpr double reductionTolerance = 0.3;  // Уменьшение диаметра под канавку, мм
+    static constexpr double pi = 3.14159265358979323846;
+
+    /**
+     * @brief Рассчитать величины по параметрам, вводимым пользователем
+     * @param totalLength Общая длина вала
+     * @param cylinder4Diameter Диаметр 4-го цилиндра
+     * @param cylinder9Diameter Диаметр 9-го цилиндра
+     */
+    static ShaftReadout analyze(double totalLength, double cylinder4Diameter, double cylinder9Diameter,
+                                double density = steelDensity) {
+        std::vector<std::string> violations;
+        if (totalLength <= 200 || totalLength >= 300) {
+            violations.push_back("Total length must be between 200 mm and 300 mm");
+        }
+        if (cylinder4Diameter <= 20 || cylinder4Diameter >= 35) {
+            violations.push_back("Cylinder 4 diameter must be between 20 mm and 35 mm");
+        }
+        if (cylinder9Diameter <= 20 || cylinder9Diameter >= 35) {
+            violations.push_back("Cylinder 9 diameter must be between 20 mm and 35 mm");
+        }
+        if (totalLength <= 0 || cylinder4Diameter <= 0 || cylinder9Diameter <= 0) {
+            ShaftReadout readout;
+            readout.violations = violations;
+            return readout;
+        }
+        // Вызывается на каждое изменение параметров в GUI, журнал пересчёта здесь не нужен
+        ShaftReadout readout = analyze(ShaftProportions(totalLength, cylinder4Diameter, cylinder9Diameter, false), density);
+        readout.violations.insert(readout.violations.begin(), violations.begin(), violations.end());
+        return readout;
+    }
+
+    /**
+     * @brief Рассчитать величины по готовым пропорциям
+     */
+    static ShaftReadout analyze(const ShaftProportions& proportions, double density = steelDensity) {
+        ShaftReadout readout;
+        readout.baseDiameter = proportions.getBaseDiameter();
+        readout.chamferLength = proportions.getChamferLength();
+
+        const size_t segmentCount = proportions.getSegmentCount();
+        double z = 0.0;
+        for (size_t i = 0; i < segmentCount; ++i) {
+            auto info = proportions.getSegmentInfo(i);
+            SegmentReadout segment;
+            segment.name = proportions.getSegmentName(i);
+            segment.type = std::get<0>(info);
+            segment.length = std::get<1>(info);
+            segment.diameter = std::get<2>(info);
+            segment.diameterEnd = std::get<3>(info);
+            segment.reduced = std::get<4>(info) && segment.type == "cylinder";
+            if (i == 0 || i == segmentCount - 1) segment.length += readout.chamferLength;
+            if (segment.reduced) segment.diameter -= reductionTolerance;
+            segment.zStart = z;
+            z += segment.length;
+
+            if (segment.diameter <= 0 || (segment.type == "cone" && segment.diameterEnd <= 0)) {
+                readout.violations.push_back(segment.name + " has a non-positive diameter");
+            }
+            readout.volume += segmentVolume(segment);
+            readout.segments.push_back(segment);
+        }
+        readout.totalLength = z;
+
+        if (!readout.segments.empty()) {
+            readout.volume -= chamferVolume(readout.segments.front().diameter / 2.0, readout.chamferLength);
+            const SegmentReadout& last = readout.segments.back();
+            double lastRadius = (last.type == "cone" ? last.diameterEnd : last.diameter) / 2.0;
+            readout.volume -= chamferVolume(lastRadius, readout.chamferLength);
+        }
+
+        for (size_t i = 0; i < proportions.getSlotCount(); ++i) {
+            auto info = proportions.getSlotInfo(i);
+            SlotReadout slot;
+            slot.width = std::get<0>(info);
+            slot.depth = std::get<1>(info);
+            slot.length = std::get<2>(info);
+            double offset = std::get<3>(info);
+            slot.segmentIndex = std::get<4>(info);
+            if (slot.segmentIndex < 0 || static_cast<size_t>(slot.segmentIndex) >= readout.segments.size()) {
+                readout.violations.push_back("Slot " + std::to_string(i) + " refers to a missing segment");
+                continue;
+            }
+            const SegmentReadout& host = readout.segments[slot.segmentIndex];
+            slot.hostDiameter = proportions.getSegmentDiameter(slot.segmentIndex);
+            slot.zStart = host.zStart + offset;
+            if (slot.zStart + slot.length > host.zEnd()) {
+                slot.length = std::max(0.0, host.zEnd() - slot.zStart);
+                readout.violations.push_back("Slot " + std::to_string(i) + " is shortened to " +
+                                             formatNumber(slot.length) + " mm by the end of " + host.name);
+            }
+            double radius = slot.hostDiameter / 2.0;
+            if (slot.depth > radius) {
+                readout.violations.push_back("Slot " + std::to_string(i) + " depth exceeds the radius of " + host.name);
+            } else if (slot.width >= slot.hostDiameter) {
+                readout.violations.push_back("Slot " + std::to_string(i) + " is wider than " + host.name);
+            } else {
+                readout.volume -= slotVolume(radius, slot.width, slot.depth, slot.length);
+            }
+            readout.slotDetails.push_back(slot);
+        }
+
+        readout.mass = readout.volume * density;
+        return readout;
+    }
+
+    /**
+     * @brief Канонический ключ вала: размеры, округлённые до 1e-6 мм, в фиксированном порядке
+     *
+     * Ключ строится по размерам, которые получает ShaftBuilder, поэтому совпадает
+     * у валов, заданных разными, но геометрически эквивалентными параметрами.
+     */
+    static std::string canonicalKey(const ShaftProportions& proportions) {
+        ShaftReadout readout = analyze(proportions);
+        std::ostringstream key;
+        appendKeyValue(key, readout.chamferLength);
+        key << readout.segments.size() << '|';
+        for (const SegmentReadout& segment : readout.segments) {
+            key << segment.type << ';';
+            appendKeyValue(key, segment.zStart);
+            appendKeyValue(key, segment.length);
+            appendKeyValue(key, segment.diameter);
+            appendKeyValue(key, segment.diameterEnd);
+        }
+        key << readout.slotDetails.size() << '|';
+        for (const SlotReadout& slot : readout.slotDetails) {
+            key << slot.segmentIndex << ';';
+            appendKeyValue(key, slot.zStart);
+            appendKeyValue(key, slot.width);
+            appendKeyValue(key, slot.depth);
+            appendKeyValue(key, slot.length);
+            appendKeyValue(key, slot.hostDiameter);
+        }
+        return key.str();
+    }
+
+private:
+    /**
+     * @brief Записать размер, округлённый до 1e-6 мм, чтобы шум вычислений не разделял одинаковые валы
+     */
+    static void appendKeyValue(std::ostringstream& key, double value) {
+        key << std::llround(value * 1e6) << ';';
+    }
+
+    static double segmentVolume(const SegmentReadout& segment) {
+        double r1 = segment.diameter / 2.0;
+        if (segment.type == "cone") {
+            double r2 = segment.diameterEnd / 2.0;
+            return pi * segment.length * (r1 * r1 + r1 * r2 + r2 * r2) / 3.0;
+        }
+        return pi * r1 * r1 * segment.length;
+    }
+
+    /**
+     * @brief Объём кольца, снимаемого фаской 45° на торце радиуса radius
+     */
+    static double chamferVolume(double radius, double chamfer) {
+        return 2.0 * pi * (radius - chamfer / 3.0) * chamfer * chamfer / 2.0;
+    }
+
+    /**
+     * @brief Объём материала, снимаемого пазом со скруглёнными концами на цилиндре радиуса radius
+     *
+     * Для каждого x поперёк паза глубина выборки h(x) = sqrt(R² - x²) - (R - depth), а длина
+     * выборки - прямой участок плюс хорды двух полукругов: length + 2 sqrt(w²/4 - x²).
+     * Интеграл по x считается методом Симпсона.
+     */
+    static double slotVolume(double radius, double width, double depth, double length) {
+        const int steps = 64;
+        const double halfWidth = width / 2.0;
+        const double h = width / steps;
+        double sum = 0.0;
+        for (int k = 0; k <= steps; ++k) {
+            double x = -halfWidth + k * h;
+            double cutDepth = std::max(0.0, std::sqrt(std::max(0.0, radius * radius - x * x)) - (radius - depth));
+            double cutLength = length + 2.0 * std::sqrt(std::max(0.0, halfWidth * halfWidth - x * x));
+            double weight = (k == 0 || k == steps) ? 1.0 : (k % 2 ? 4.0 : 2.0);
+            sum += weight * cutDepth * cutLength;
+        }
+        return sum * h / 3.0;
+    }
+
+    static std::string formatNumber(double value) {
+        std::ostringstream text;
+        text.precision(3);
+        text << value;
+        return text.str();
+    }
+};
+
+#endif // SHAFT_ANALYSIS_H
@@ -1,4 +1,6 @@
 #include "ShaftAppCore.h"
+#include "ShaftAnalysis.h"
+#include <chrono>
 #include <iostream>
 #include <Standard_DefineAlloc.hxx>
 
@@ -13,25 +15,103 @@ ShaftAppCore::ShaftAppCore(
     Standard_Real chamferAngle)
     : builder(chamferLength, chamferAngle),
     proportions(totalLength, cylinder4Diameter, cylinder9Diameter),
-    m_hasConfigurationErrors(false) {}
+    m_hasConfigurationErrors(false),
+    m_snapshotDirty(false) {
+    m_history.commit(proportions, "Initial");
+}
+
+namespace {
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
 
 /**
  * @brief Запустить построение вала
  */
 int ShaftAppCore::run(const std::string& exportFilename) {
+    m_timings = RunTimings();
+    auto start = std::chrono::steady_clock::now();
+    int result = buildShaft();
+    m_timings.buildSeconds = secondsSince(start);
+    if (result != 0) return result;
+    start = std::chrono::steady_clock::now();
+    bool exported = builder.exportToSTEP(exportFilename);
+    m_timings.exportSeconds = secondsSince(start);
+    if (!exported) return 1;
+    std::cout << "Shaft construction completed successfully." << std::endl;
+    return 0;
+}
+
+/**
+ * @brief Запустить построение вала с выгрузкой результата в поток
+ */
+int ShaftAppCore::run(std::ostream& output, ExportFormat format) {
+    m_timings = RunTimings();
+    auto start = std::chrono::steady_clock::now();
+    int result = buildShaft();
+    m_timings.buildSeconds = secondsSince(start);
+    if (result != 0) return result;
+    start = std::chrono::steady_clock::now();
+    bool exported = builder.exportToStream(output, format);
+    m_timings.exportSeconds = secondsSince(start);
+    if (!exported) return 1;
+    std::cout << "Shaft construction completed successfully." << std::endl;
+    return 0;
+}
+
+/**
+ * @brief Построить вал по текущим пропорциям без экспорта
+ */
+int ShaftAppCore::buildShaft() {
     resetConfigurationErrors();
     if (m_hasConfigurationErrors) {
         std::cerr << "Cannot build shaft due to configuration errors. Please fix them first." << std::endl;
         return 1;
     }
+    int snapshot = commitSnapshot();
+    const std::string settings = buildSettings();
+    const ShaftSnapshot& cached = m_history.at(snapshot);
+    // Вал снимка годится только для тех же настроек построителя
+    if (!cached.shape.IsNull() && cached.buildSettings == settings) {
+        const TopoDS_Shape shape = cached.shape;
+        std::cout << "Using cached geometry of " << cached.label << std::endl;
+        CheckLevel passedLevel = cached.checkLevel;
+        double passedLimit = cached.toleranceLimit;
+        if (!useCachedShape(shape, passedLevel, passedLimit)) return 1;
+        m_history.attachShape(snapshot, shape, settings, passedLevel, passedLimit);
+        return 0;
+    }
+    // Порядок пазов и слияние граней меняют топологию, поэтому входят в ключ. Уровень проверки
+    // в ключ не входит: он хранится в записи, и вал из записи с более слабой проверкой
+    // проверяется заново, так что снимок, заполненный быстрым прогоном, годится и для строгого
+    std::string cacheKey;
+    if (m_shapeCache) {
+        cacheKey = ShaftAnalysis::canonicalKey(proportions) + ";" + settings;
+        TopoDS_Shape shape;
+        CheckLevel passedLevel = CheckLevel::None;
+        double passedLimit = 0.0;
+        if (m_shapeCache->find(cacheKey, shape, passedLevel, passedLimit)) {
+            std::cout << "Using cached geometry from " << m_shapeCache->getFilename() << std::endl;
+            if (!useCachedShape(shape, passedLevel, passedLimit)) return 1;
+            m_history.attachShape(snapshot, shape, settings, passedLevel, passedLimit);
+            return 0;
+        }
+    }
     std::cout << "Starting shaft construction with total length "
               << proportions.getTotalLength() << " mm..." << std::endl;
 
     try {
         builder.buildFromProportions(proportions);
         builder.build();
-        builder.exportToSTEP(exportFilename);
-        std::cout << "Shaft construction completed successfully." << std::endl;
+        if (!reportValidation()) return 1;
+        m_history.attachShape(snapshot, builder.getFinalShape(), settings, builder.getCheckLevel(),
+                              builder.getToleranceLimit());
+        if (m_shapeCache) {
+            m_shapeCache->store(cacheKey, builder.getFinalShape(), builder.getCheckLevel(), builder.getToleranceLimit());
+        }
         return 0;
     } catch (const std::exception& e) {
         std::cerr << "Error during shaft construction: " << e.what() << std::endl;
@@ -39,6 +119,48 @@ int ShaftAppCore::run(const std::string& exportFilename) {
     }
 }
 
+/**
+ * @brief Настройки построителя, от которых зависит геометрия
+ */
+std::string ShaftAppCore::buildSettings() const {
+    std::string settings;
+    switch (builder.getFeaturePipeline()) {
+    case FeaturePipeline::SegmentLocal: settings = "local"; break;
+    case FeaturePipeline::Sequential: settings = "sequential"; break;
+    default: settings = "global"; break;
+    }
+    settings += builder.getCompaction() ? ";compact" : ";full";
+    return settings;
+}
+
+/**
+ * @brief Подставить ранее построенный вал с проверкой текущего уровня
+ */
+bool ShaftAppCore::useCachedShape(const TopoDS_Shape& shape, CheckLevel& passedLevel, double& passedLimit) {
+    builder.setFinalShape(shape);
+    m_timings.fromCache = true;
+    const CheckLevel level = builder.getCheckLevel();
+    if (level == CheckLevel::None) return true;
+    if (level <= passedLevel && builder.getToleranceLimit() >= passedLimit) return true;
+    builder.validate();
+    if (!reportValidation()) return false;
+    passedLevel = level;
+    passedLimit = builder.getToleranceLimit();
+    return true;
+}
+
+/**
+ * @brief Сообщить об ошибках последней проверки
+ */
+bool ShaftAppCore::reportValidation() const {
+    const ValidationReport& validation = builder.getValidationReport();
+    if (validation.isValid()) return true;
+    const ValidationIssue& issue = validation.issues.front();
+    std::cerr << "Invalid shaft geometry (" << validation.issues.size() << " issue(s)): ["
+              << issue.check << "] " << issue.message << std::endl;
+    return false;
+}
+
 /**
  * @brief Задать диаметр для указанного сегмента
  */
@@ -46,6 +168,7 @@ void ShaftAppCore::setSegmentDiameter(int segmentIndex, double diameter) {
     m_hasConfigurationErrors = false;
     try {
         proportions.setCustomDiameter(segmentIndex, diameter);
+        m_snapshotDirty = true;
         std::cout << "Diameter set to " << diameter << " mm for segment "
                   << proportions.getSegmentName(segmentIndex) << std::endl;
     } catch (const std::exception& e) {
@@ -61,6 +184,7 @@ void ShaftAppCore::setTotalLength(double length) {
     m_hasConfigurationErrors = false;
     try {
         proportions.setTotalLength(length);
+        m_snapshotDirty = true;
         std::cout << "Total shaft length set to: " << length << " mm" << std::endl;
     } catch (const std::exception& e) {
         std::cerr << "Error setting shaft length: " << e.what() << std::endl;
@@ -68,9 +192,96 @@ void ShaftAppCore::setTotalLength(double length) {
     }
 }
 
+/**
+ * @brief Задать порядок применения пазов при построении
+ */
+void ShaftAppCore::setFeaturePipeline(FeaturePipeline pipeline) {
+    builder.setFeaturePipeline(pipeline);
+}
+
+/**
+ * @brief Задать уровень проверки геометрии
+ */
+void ShaftAppCore::setCheckLevel(CheckLevel level) {
+    builder.setCheckLevel(level);
+}
+
+/**
+ * @brief Задать допуск проверки роста допусков
+ */
+void ShaftAppCore::setToleranceLimit(double limit) {
+    builder.setToleranceLimit(limit);
+}
+
+/**
+ * @brief Включить слияние граней одной поверхности
+ */
+void ShaftAppCore::setCompaction(bool enabled) {
+    builder.setCompaction(enabled);
+}
+
+/**
+ * @brief Брать валы из файла-снимка и дописывать в него новые
+ */
+void ShaftAppCore::setShapeCache(const std::string& filename) {
+    if (filename.empty()) m_shapeCache.reset();
+    else m_shapeCache = std::make_unique<ShapeCacheFile>(filename);
+}
+
 /**
  * @brief Сбрасывает флаг ошибок конфигурации
  */
 void ShaftAppCore::resetConfigurationErrors() {
     m_hasConfigurationErrors = false;
 }
+
+/**
+ * @brief Зафиксировать текущие параметры снимком истории, если они изменились
+ */
+int ShaftAppCore::commitSnapshot(const std::string& label) {
+    if (m_snapshotDirty && !proportions.sameAs(m_history.current()->proportions)) {
+        m_history.commit(proportions, label);
+    }
+    m_snapshotDirty = false;
+    return m_history.currentIndex();
+}
+
+/**
+ * @brief Вернуть параметры предыдущего снимка
+ */
+bool ShaftAppCore::undo() {
+    commitSnapshot();
+    const ShaftSnapshot* snapshot = m_history.undo();
+    if (!snapshot) return false;
+    proportions = snapshot->proportions;
+    return true;
+}
+
+/**
+ * @brief Вернуть параметры отменённого снимка
+ */
+bool ShaftAppCore::redo() {
+    if (m_snapshotDirty && !proportions.sameAs(m_history.current()->proportions)) return false;
+    const ShaftSnapshot* snapshot = m_history.redo();
+    if (!snapshot) return false;
+    proportions = snapshot->proportions;
+    m_snapshotDirty = false;
+    return true;
+}
+
+/**
+ * @brief Переключиться на произвольный снимок
+ */
+void ShaftAppCore::checkoutSnapshot(int index) {
+    commitSnapshot();
+    proportions = m_history.checkout(index).proportions;
+}
+
+/**
+ * @brief Удалить историю снимков и кэшированные валы
+ */
+void ShaftAppCore::clearHistory() {
+    m_history = ShaftHistory();
+    m_history.commit(proportions, "Initial");
+    m_snapshotDirty = false;
+}
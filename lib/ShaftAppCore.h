@@ -3,9 +3,22 @@
 
 #include "ShaftBuilder.h"
 #include "ShaftProportions.h"
+#include "ShaftHistory.h"
+#include "ShapeCacheFile.h"
+#include <memory>
 #include <string>
 #include <Standard_TypeDef.hxx>
 
+/**
+ * @struct RunTimings
+ * @brief Время этапов последнего запуска
+ */
+struct RunTimings {
+    double buildSeconds = 0.0;   // Построение или чтение из кэша
+    double exportSeconds = 0.0;  // Экспорт результата
+    bool fromCache = false;      // Вал взят из истории или файла-снимка
+};
+
 /**
  * @class ShaftAppCore
  * @brief Основной класс для построения вала, переиспользуемый в консольных и GUI приложениях
@@ -15,6 +28,10 @@ private:
     ShaftBuilder builder;
     ShaftProportions proportions;
     bool m_hasConfigurationErrors;
+    ShaftHistory m_history;
+    bool m_snapshotDirty;  // Параметры изменены после последнего снимка
+    std::unique_ptr<ShapeCacheFile> m_shapeCache;  // Файл-снимок построенных валов, если задан
+    RunTimings m_timings;
 
 public:
     /**
@@ -39,6 +56,14 @@ public:
      */
     int run(const std::string& exportFilename);
 
+    /**
+     * @brief Запустить построение вала с выгрузкой результата в поток
+     * @param output Поток для записи результата
+     * @param format Формат выгрузки
+     * @return 0 при успехе, иначе код ошибки
+     */
+    int run(std::ostream& output, ExportFormat format);
+
     /**
      * @brief Задать диаметр для указанного сегмента
      * @param segmentIndex Индекс сегмента
@@ -52,10 +77,106 @@ public:
      */
     void setTotalLength(double length);
 
+    /**
+     * @brief Задать порядок применения пазов при построении
+     * @param pipeline Глобальный или посегментный режим
+     */
+    void setFeaturePipeline(FeaturePipeline pipeline);
+
+    /**
+     * @brief Задать уровень проверки геометрии; вал с ошибками не экспортируется
+     * @param level Уровень проверки
+     */
+    void setCheckLevel(CheckLevel level);
+
+    /**
+     * @brief Задать допуск, превышение которого проверка считает ростом допусков
+     * @param limit Допуск, мм
+     */
+    void setToleranceLimit(double limit);
+
+    /**
+     * @brief Включить слияние граней одной поверхности после объединения сегментов
+     * @param enabled true - сливать грани
+     */
+    void setCompaction(bool enabled);
+
+    /**
+     * @brief Брать валы из файла-снимка и дописывать в него новые
+     * @param filename Имя файла; пустая строка отключает снимок
+     */
+    void setShapeCache(const std::string& filename);
+
+    /**
+     * @brief Время этапов последнего запуска
+     */
+    const RunTimings& getLastTimings() const { return m_timings; }
+
     /**
      * @brief Сбрасывает флаг ошибок конфигурации
      */
     void resetConfigurationErrors();
+
+    /**
+     * @brief Зафиксировать текущие параметры снимком истории, если они изменились
+     * @param label Подпись снимка
+     * @return Индекс текущего снимка
+     */
+    int commitSnapshot(const std::string& label = std::string());
+
+    /**
+     * @brief Вернуть параметры предыдущего снимка
+     * @return true, если отмена выполнена
+     */
+    bool undo();
+
+    /**
+     * @brief Вернуть параметры отменённого снимка
+     * @return true, если повтор выполнен
+     */
+    bool redo();
+
+    /**
+     * @brief Переключиться на произвольный снимок (вариант "что если")
+     * @param index Индекс снимка
+     */
+    void checkoutSnapshot(int index);
+
+    /**
+     * @brief Удалить историю снимков и кэшированные валы, оставив текущие параметры
+     */
+    void clearHistory();
+
+    const ShaftProportions& getProportions() const { return proportions; }
+    const ShaftHistory& getHistory() const { return m_history; }
+
+private:
+    /**
+     * @brief Построить вал по текущим пропорциям без экспорта
+     * @return 0 при успехе, иначе код ошибки
+     */
+    int buildShaft();
+
+    /**
+     * @brief Настройки построителя, от которых зависит геометрия (порядок пазов, слияние граней)
+     */
+    std::string buildSettings() const;
+
+    /**
+     * @brief Подставить ранее построенный вал, проверив его, если он прошёл более слабую проверку
+     *
+     * Проверка слабее, если её уровень ниже текущего или предел допусков больше текущего.
+     * @param passedLevel Пройденный уровень; после повторной проверки - текущий уровень
+     * @param passedLimit Предел допусков пройденной проверки; после повторной проверки - текущий
+     * @return false, если вал не прошёл проверку текущего уровня
+     */
+    bool useCachedShape(const TopoDS_Shape& shape, CheckLevel& passedLevel, double& passedLimit);
+
+    /**
+     * @brief Сообщить об ошибках последней проверки построителя
+     * @return true, если проверка пройдена
+     */
+    bool reportValidation() const;
 };
 
 #endif // SHAFT_APP_CORE_H
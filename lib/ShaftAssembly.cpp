@@ -0,0 +1,97 @@
+#include "ShaftAssembly.h"
+#include "ShaftAnalysis.h"
+#include <XCAFApp_Application.hxx>
+#include <XCAFDoc_DocumentTool.hxx>
+#include <XCAFDoc_ShapeTool.hxx>
+#include <TDocStd_Document.hxx>
+#include <TDataStd_Name.hxx>
+#include <TDF_Label.hxx>
+#include <TopLoc_Location.hxx>
+#include <STEPCAFControl_Writer.hxx>
+#include <Standard_Failure.hxx>
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+std::uint64_t ShaftAssembly::hashKey(const std::string& key) {
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : key) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+size_t ShaftAssembly::addInstance(const std::string& name, const ShaftProportions& proportions,
+                                  const gp_Trsf& placement) {
+    const std::string key = ShaftAnalysis::canonicalKey(proportions);
+    auto found = m_prototypeByKey.find(key);
+    size_t prototype;
+    if (found != m_prototypeByKey.end()) {
+        prototype = found->second;
+    } else {
+        char hash[32];
+        std::snprintf(hash, sizeof(hash), "%016llx", static_cast<unsigned long long>(hashKey(key)));
+        prototype = m_prototypes.size();
+        m_prototypes.push_back(Prototype{std::string("Shaft_") + hash, proportions, TopoDS_Shape()});
+        m_prototypeByKey.emplace(key, prototype);
+    }
+    m_instances.push_back(Instance{name, prototype, placement});
+    return prototype;
+}
+
+void ShaftAssembly::setPrototypeShape(size_t prototype, const TopoDS_Shape& shape) {
+    if (prototype >= m_prototypes.size()) throw std::out_of_range("Prototype index out of valid range");
+    m_prototypes[prototype].shape = shape;
+}
+
+bool ShaftAssembly::exportToSTEP(const std::string& filename) const {
+    for (const Prototype& prototype : m_prototypes) {
+        if (prototype.shape.IsNull()) {
+            std::cerr << "Error: " << prototype.name << " is not built" << std::endl;
+            return false;
+        }
+    }
+
+    Handle(XCAFApp_Application) application = XCAFApp_Application::GetApplication();
+    Handle(TDocStd_Document) document;
+    application->NewDocument("MDTV-XCAF", document);
+    Handle(XCAFDoc_ShapeTool) shapeTool = XCAFDoc_DocumentTool::ShapeTool(document->Main());
+
+    bool success = false;
+    try {
+        // Прототипы добавляются как отдельные детали, экземпляры - как компоненты со своим положением
+        std::vector<TDF_Label> prototypeLabels;
+        prototypeLabels.reserve(m_prototypes.size());
+        for (const Prototype& prototype : m_prototypes) {
+            TDF_Label label = shapeTool->AddShape(prototype.shape, Standard_False);
+            TDataStd_Name::Set(label, prototype.name.c_str());
+            prototypeLabels.push_back(label);
+        }
+        TDF_Label assembly = shapeTool->NewShape();
+        TDataStd_Name::Set(assembly, "Shaft assembly");
+        for (const Instance& instance : m_instances) {
+            TDF_Label component = shapeTool->AddComponent(assembly, prototypeLabels[instance.prototype],
+                                                          TopLoc_Location(instance.placement));
+            TDataStd_Name::Set(component, instance.name.c_str());
+        }
+        shapeTool->UpdateAssemblies();
+
+        STEPCAFControl_Writer writer;
+        writer.SetNameMode(Standard_True);
+        if (!writer.Transfer(document, STEPControl_AsIs)) {
+            std::cout << "STEP transfer failed" << std::endl;
+        } else if (writer.Write(filename.c_str()) != IFSelect_RetDone) {
+            std::cout << "STEP write failed" << std::endl;
+        } else {
+            std::cout << "Assembly of " << m_instances.size() << " shafts (" << m_prototypes.size()
+                      << " unique) exported to " << filename << std::endl;
+            success = true;
+        }
+    } catch (const Standard_Failure& e) {
+        std::cerr << "Error exporting assembly: " << e.GetMessageString() << std::endl;
+    }
+    application->Close(document);
+    return success;
+}
@@ -0,0 +1,77 @@
+/**
+ * @file ShaftAssembly.h
+ * @brief Сборка из нескольких валов с экспортом одного STEP файла без дублирования геометрии
+ */
+
+#ifndef SHAFT_ASSEMBLY_H
+#define SHAFT_ASSEMBLY_H
+
+#include "ShaftProportions.h"
+#include <TopoDS_Shape.hxx>
+#include <gp_Trsf.hxx>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * @class ShaftAssembly
+ * @brief Набор размещённых валов, в котором одинаковые валы хранятся один раз
+ *
+ * Валы сравниваются по каноническому ключу ShaftAnalysis::canonicalKey, составленному
+ * из итоговых размеров сегментов, фасок и пазов. Каждый уникальный вал (прототип) записывается в STEP один раз, а экземпляры
+ * ссылаются на него со своим положением.
+ */
+class ShaftAssembly {
+public:
+    /**
+     * @struct Prototype
+     * @brief Уникальный вал сборки
+     */
+    struct Prototype {
+        std::string name;               // Имя в STEP, содержит хэш ключа
+        ShaftProportions proportions;   // Параметры первого экземпляра
+        TopoDS_Shape shape;             // Построенный вал, пустой до построения
+    };
+
+    /**
+     * @struct Instance
+     * @brief Размещённый в сборке вал
+     */
+    struct Instance {
+        std::string name;
+        size_t prototype;
+        gp_Trsf placement;
+    };
+
+    /**
+     * @brief 64-битный хэш FNV-1a ключа для имён прототипов
+     */
+    static std::uint64_t hashKey(const std::string& key);
+
+    /**
+     * @brief Добавить экземпляр вала
+     * @return Индекс прототипа, на который ссылается экземпляр
+     */
+    size_t addInstance(const std::string& name, const ShaftProportions& proportions, const gp_Trsf& placement);
+
+    /**
+     * @brief Задать построенный вал прототипа, например полученный от рабочего процесса
+     */
+    void setPrototypeShape(size_t prototype, const TopoDS_Shape& shape);
+
+    /**
+     * @brief Записать сборку в STEP: каждый прототип один раз, экземпляры - ссылками на него
+     */
+    bool exportToSTEP(const std::string& filename) const;
+
+    const std::vector<Prototype>& getPrototypes() const { return m_prototypes; }
+    const std::vector<Instance>& getInstances() const { return m_instances; }
+
+private:
+    std::vector<Prototype> m_prototypes;
+    std::vector<Instance> m_instances;
+    std::map<std::string, size_t> m_prototypeByKey;
+};
+
+#endif // SHAFT_ASSEMBLY_H
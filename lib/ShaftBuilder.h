@@ -12,6 +12,7 @@
 #include <BRepAlgoAPI_Fuse.hxx>          // Операция объединения тел
 #include <BRepAlgoAPI_Cut.hxx>           // Операция вычитания тел
 #include <STEPControl_Writer.hxx>        // Запись в формат STEP
+#include <BRepTools.hxx>                 // Запись в формат BRep
 #include <TopoDS_Shape.hxx>              // Базовый класс для топологических объектов
 #include <gp_Ax2.hxx>                    // Ось для построения геометрических примитивов
 #include <gp_Pnt.hxx>                    // Точка в 3D пространстве
@@ -25,14 +26,23 @@
 #include <BRep_Tool.hxx>                 // Инструменты для работы с геометрией
 #include <BRepBndLib.hxx>                // Работа с ограничивающими боксами
 #include <Bnd_Box.hxx>                   // Ограничивающий бокс
+#include <TopTools_ListOfShape.hxx>      // Список топологических объектов
+#include <OSD_Parallel.hxx>              // Параллельное выполнение циклов
+#include <ShapeUpgrade_UnifySameDomain.hxx> // Слияние граней и рёбер одной поверхности
+#include <BRepTools_History.hxx>         // История изменения подформ
+#include <BRepAdaptor_Surface.hxx>       // Тип поверхности грани
+#include <chrono>
 #include <iostream>
+#include <ostream>
 #include <vector>
 #include <memory>
 #include <string>
+#include <stdexcept>
 #include <Standard_DefineAlloc.hxx>
 
 #include "Slot.h"  // Подключаем класс Slot
 #include "ShaftProportions.h"
+#include "ShaftValidator.h"
 
 /**
  * @class ShaftSegment
@@ -95,6 +105,37 @@ public:
     Standard_Real getRadiusEnd() const { return radiusEnd; }
 };
 
+/**
+ * @enum FeaturePipeline
+ * @brief Порядок применения конструктивных элементов (пазов) к валу
+ */
+enum class FeaturePipeline {
+    Global,       // Пазы вырезаются из целого вала после объединения сегментов и фасок
+    SegmentLocal, // Пазы вырезаются из своего сегмента параллельно, затем сегменты объединяются
+    Sequential    // Исходный порядок: сегменты объединяются по одному, пазы вырезаются по одному (эталон)
+};
+
+/**
+ * @enum ExportFormat
+ * @brief Формат выгрузки готового вала в поток
+ */
+enum class ExportFormat {
+    STEP,  // STEP, как при записи в файл
+    BRep   // Собственный формат OpenCASCADE, быстрый для записи и чтения
+};
+
+/**
+ * @struct CompactionStats
+ * @brief Топология вала до и после слияния граней
+ */
+struct CompactionStats {
+    int facesBefore = 0;
+    int edgesBefore = 0;
+    int facesAfter = 0;
+    int edgesAfter = 0;
+    double seconds = 0.0;
+};
+
 /**
  * @class ShaftBuilder
  * @brief Класс для построения полного вала
@@ -102,15 +143,54 @@ public:
 class ShaftBuilder {
 private:
     std::vector<Slot> m_slots;                             // Пазы на валу
+    std::vector<int> m_slotSegments;                     // Индексы сегментов, на которых лежат пазы (-1 - неизвестен)
+    FeaturePipeline m_pipeline;                          // Порядок применения пазов
     std::vector<std::unique_ptr<ShaftSegment>> segments; // Сегменты вала
     Standard_Real chamferLength;                         // Длина фаски
     Standard_Real chamferAngle;                          // Угол фаски в градусах
     TopoDS_Shape finalShape;                             // Итоговая форма вала
     Standard_Real currentZCoord;                         // Текущая координата Z для добавления сегментов
+    CheckLevel m_checkLevel;                             // Уровень проверки результата построения
+    double m_toleranceLimit;                             // Допуск, рост выше которого считается ошибкой, мм
+    ValidationReport m_validation;                       // Результат последней проверки
+    bool m_compaction;                                   // Сливать грани одной поверхности после объединения
+    CompactionStats m_compactionStats;                   // Результат последнего слияния
+    TopoDS_Face m_startFace;                             // Торцевая грань Z = zMin (отслеживается для фасок)
+    TopoDS_Face m_endFace;                               // Торцевая грань Z = zMax
 
 public:
     ShaftBuilder(Standard_Real chamferLength = 0.025, Standard_Real chamferAngle = 45.0)
-        : chamferLength(chamferLength), chamferAngle(chamferAngle), currentZCoord(0.0) {}
+        : m_pipeline(FeaturePipeline::Global), chamferLength(chamferLength), chamferAngle(chamferAngle),
+        currentZCoord(0.0), m_checkLevel(CheckLevel::None), m_toleranceLimit(ShaftValidator::defaultToleranceLimit),
+        m_compaction(false) {}
+
+    void setFeaturePipeline(FeaturePipeline pipeline) { m_pipeline = pipeline; }
+    FeaturePipeline getFeaturePipeline() const { return m_pipeline; }
+
+    /**
+     * @brief Включить проверку корректности вала в конце build()
+     */
+    void setCheckLevel(CheckLevel level) { m_checkLevel = level; }
+    CheckLevel getCheckLevel() const { return m_checkLevel; }
+
+    /**
+     * @brief Задать допуск, превышение которого проверка считает ростом допусков, мм
+     */
+    void setToleranceLimit(double limit) {
+        if (!(limit > 0.0)) throw std::invalid_argument("Tolerance limit must be positive");
+        m_toleranceLimit = limit;
+    }
+    double getToleranceLimit() const { return m_toleranceLimit; }
+    const ValidationReport& getValidationReport() const { return m_validation; }
+
+    /**
+     * @brief Включить слияние граней и рёбер одной поверхности после объединения сегментов
+     *
+     * Фаски и пазы строятся уже на сжатой топологии, а STEP получается меньше.
+     */
+    void setCompaction(bool enabled) { m_compaction = enabled; }
+    bool getCompaction() const { return m_compaction; }
+    const CompactionStats& getCompactionStats() const { return m_compactionStats; }
 
     void addCylinder(Standard_Real length, Standard_Real diameter, Standard_Real zStart = -1.0) {
         if (zStart < 0.0) zStart = currentZCoord;
@@ -131,6 +211,11 @@ public:
 
     const TopoDS_Shape& getFinalShape() const { return finalShape; }
 
+    /**
+     * @brief Подставить ранее построенный вал, например из кэша снимков, для экспорта без перестроения
+     */
+    void setFinalShape(const TopoDS_Shape& shape) { finalShape = shape; }
+
     bool reduceCylinderDiameter(size_t index, Standard_Real tolerance = 0.3) {
         if (index >= segments.size()) {
             std::cerr << "Error: Segment index " << index << " out of range" << std::endl;
@@ -151,23 +236,54 @@ public:
     }
 
     void addSlot(Standard_Real width, Standard_Real depth, Standard_Real length,
-                 Standard_Real zStart, Standard_Real cylinderRadius) {
-        m_slots.push_back(Slot(width, depth, length, zStart, cylinderRadius));
+                 Standard_Real zStart, Standard_Real cylinderRadius, int segmentIndex = -1,
+                 SlotForm form = SlotForm::EndMilled, Standard_Real cutterRadius = 0.0) {
+        m_slots.push_back(Slot(width, depth, length, zStart, cylinderRadius, form, cutterRadius));
+        m_slotSegments.push_back(segmentIndex);
         std::cout << "Slot added (Z=" << zStart << " to " << zStart + length
                   << ", width=" << width << ", depth=" << depth << ")" << std::endl;
     }
 
     void build() {
         if (segments.empty()) throw std::runtime_error("No segments to build the shaft");
-        finalShape = segments[0]->create();
-        for (size_t i = 1; i < segments.size(); ++i) {
-            BRepAlgoAPI_Fuse fuse(finalShape, segments[i]->create());
-            if (!fuse.IsDone()) throw std::runtime_error("Error fusing segment " + std::to_string(i));
-            finalShape = fuse.Shape();
+        if (m_pipeline == FeaturePipeline::SegmentLocal) {
+            buildSegmentLocal();
+            validate();
+            return;
         }
+        if (m_pipeline == FeaturePipeline::Sequential) {
+            buildSequential();
+            validate();
+            return;
+        }
+        // Все сегменты объединяются одной операцией: последовательное объединение
+        // с накопленным телом дорожает с каждым новым сегментом
+        std::vector<TopoDS_Shape> pieces(segments.size());
+        for (size_t i = 0; i < segments.size(); ++i) pieces[i] = segments[i]->create();
+        // Торцевые грани берутся с крайних сегментов и отслеживаются через историю объединения,
+        // поэтому грани и рёбра всего вала не перебираются
+        m_startFace = endFaceAt(pieces.front(), segments.front()->getZStart());
+        m_endFace = endFaceAt(pieces.back(), segments.back()->getZEnd());
+        Handle(BRepTools_History) history;
+        finalShape = fuseSegments(pieces, &history);
+        m_startFace = remapFace(history, m_startFace);
+        m_endFace = remapFace(history, m_endFace);
         std::cout << "Segments fused successfully" << std::endl;
+        if (m_compaction) compact();
         addChamfers();
-        cutSlots();
+        std::vector<size_t> slotIndices(m_slots.size());
+        for (size_t i = 0; i < slotIndices.size(); ++i) slotIndices[i] = i;
+        cutSlots(slotIndices);
+        validate();
+    }
+
+    /**
+     * @brief Проверить итоговую форму с заданным уровнем; при CheckLevel::None отчёт пустой
+     */
+    const ValidationReport& validate() {
+        m_validation = ShaftValidator(m_checkLevel, m_toleranceLimit).check(finalShape);
+        if (m_checkLevel != CheckLevel::None) m_validation.print(std::cout);
+        return m_validation;
     }
 
     bool exportToSTEP(const std::string& filename) const {
@@ -184,10 +300,33 @@ public:
         return true;
     }
 
+    bool exportToStream(std::ostream& stream, ExportFormat format) const {
+        if (format == ExportFormat::BRep) {
+            BRepTools::Write(finalShape, stream);
+            stream.flush();
+            if (!stream) {
+                std::cout << "BRep write failed" << std::endl;
+                return false;
+            }
+            return true;
+        }
+        STEPControl_Writer writer;
+        if (writer.Transfer(finalShape, STEPControl_AsIs) != IFSelect_RetDone) {
+            std::cout << "STEP transfer failed" << std::endl;
+            return false;
+        }
+        if (writer.WriteStream(stream) != IFSelect_RetDone || !stream) {
+            std::cout << "STEP write failed" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
     void buildFromProportions(const ShaftProportions& proportions) {
         currentZCoord = 0.0;
         segments.clear();
         m_slots.clear();
+        m_slotSegments.clear();
         size_t segmentCount = proportions.getSegmentCount();
         double chamferLength = proportions.getChamferLength();
         this->chamferLength = chamferLength;
@@ -247,75 +386,327 @@ public:
                       << ", segment actual zStart=" << segmentZStart
                       << ", slot actual zStart=" << slotZStart
                       << ", cylinder diameter=" << segmentDiameter << std::endl;
-            addSlot(width, depth, length, slotZStart, segmentDiameter / 2.0);
+            addSlot(width, depth, length, slotZStart, segmentDiameter / 2.0, static_cast<int>(segmentIndex));
         }
     }
 
 private:
     void addChamfers() {
-        Standard_Real zMin = segments.front()->getZStart();
-        Standard_Real zMax = segments.back()->getZEnd();
-        BRepFilletAPI_MakeChamfer chamferMaker(finalShape);
-        Standard_Real chamferDist = chamferLength * tan(chamferAngle * M_PI / 180.0);
-        TopTools_IndexedMapOfShape edgeMap;
-        TopExp::MapShapes(finalShape, TopAbs_EDGE, edgeMap);
-        std::cout << "Total edges found: " << edgeMap.Extent() << std::endl;
-        TopoDS_Edge leftEdge, rightEdge;
-        for (Standard_Integer i = 1; i <= edgeMap.Extent(); ++i) {
-            TopoDS_Edge edge = TopoDS::Edge(edgeMap(i));
-            TopExp_Explorer vertexExp(edge, TopAbs_VERTEX);
-            while (vertexExp.More()) {
-                TopoDS_Vertex vertex = TopoDS::Vertex(vertexExp.Current());
-                gp_Pnt pnt = BRep_Tool::Pnt(vertex);
-                if (fabs(pnt.Z() - zMin) < 1e-6 && leftEdge.IsNull()) {
-                    leftEdge = edge;
-                    std::cout << "Left edge found at Z=" << zMin << std::endl;
-                }
-                if (fabs(pnt.Z() - zMax) < 1e-6 && rightEdge.IsNull()) {
-                    rightEdge = edge;
-                    std::cout << "Right edge found at Z=" << zMax << std::endl;
-                }
-                vertexExp.Next();
+        // Вал без торцевых фасок не соответствует чертежу: ошибка фаски - ошибка построения
+        if (m_startFace.IsNull() || m_endFace.IsNull()) throw std::runtime_error("End faces for chamfers not found");
+        finalShape = chamferFaceEdges(finalShape, {m_startFace, m_endFace});
+        std::cout << "Chamfers applied, preparing to cut slots" << std::endl;
+    }
+
+    /**
+     * @brief Отследить грань через историю операции
+     * @return Новая грань, исходная грань, если она не менялась, или пустая, если удалена
+     */
+    static TopoDS_Face remapFace(const Handle(BRepTools_History)& history, const TopoDS_Face& face) {
+        if (face.IsNull() || history.IsNull()) return face;
+        if (history->IsRemoved(face)) return TopoDS_Face();
+        const TopTools_ListOfShape& modified = history->Modified(face);
+        if (modified.IsEmpty()) return face;
+        return TopoDS::Face(modified.First());
+    }
+
+    /**
+     * @brief Слить грани и рёбра, лежащие на одной поверхности, и пересчитать отслеживаемые грани
+     */
+    void compact() {
+        auto start = std::chrono::steady_clock::now();
+        TopTools_IndexedMapOfShape faces, edges;
+        TopExp::MapShapes(finalShape, TopAbs_FACE, faces);
+        TopExp::MapShapes(finalShape, TopAbs_EDGE, edges);
+        m_compactionStats = CompactionStats();
+        m_compactionStats.facesBefore = faces.Extent();
+        m_compactionStats.edgesBefore = edges.Extent();
+
+        ShapeUpgrade_UnifySameDomain unifier(finalShape, Standard_True, Standard_True, Standard_False);
+        unifier.AllowInternalEdges(Standard_False);
+        unifier.Build();
+        finalShape = unifier.Shape();
+        Handle(BRepTools_History) history = unifier.History();
+        m_startFace = remapFace(history, m_startFace);
+        m_endFace = remapFace(history, m_endFace);
+
+        faces.Clear();
+        edges.Clear();
+        TopExp::MapShapes(finalShape, TopAbs_FACE, faces);
+        TopExp::MapShapes(finalShape, TopAbs_EDGE, edges);
+        m_compactionStats.facesAfter = faces.Extent();
+        m_compactionStats.edgesAfter = edges.Extent();
+        m_compactionStats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "Compaction: faces " << m_compactionStats.facesBefore << " -> " << m_compactionStats.facesAfter
+                  << ", edges " << m_compactionStats.edgesBefore << " -> " << m_compactionStats.edgesAfter
+                  << " (" << m_compactionStats.seconds << " s)" << std::endl;
+    }
+
+    /**
+     * @brief Построение с вырезанием пазов на собственных сегментах
+     *
+     * Каждый сегмент строится и обрабатывается независимо (параллельно), поэтому
+     * булевы операции выполняются над небольшими телами. Пазы, инструмент которых
+     * выходит за границы сегмента, вырезаются из целого вала после фасок.
+     */
+    void buildSegmentLocal() {
+        const size_t segmentCount = segments.size();
+        std::vector<std::vector<size_t>> localSlots(segmentCount);
+        std::vector<size_t> globalSlots;
+        for (size_t i = 0; i < m_slots.size(); ++i) {
+            int host = m_slotSegments[i];
+            if (host >= 0 && static_cast<size_t>(host) < segmentCount && isSlotInsideSegment(m_slots[i], *segments[host])) {
+                localSlots[host].push_back(i);
+            } else {
+                globalSlots.push_back(i);
             }
         }
-        if (!leftEdge.IsNull()) {
+
+        std::vector<TopoDS_Shape> pieces(segmentCount);
+        std::vector<std::string> segmentErrors(segmentCount);
+        std::vector<std::vector<std::string>> featureErrors(segmentCount);
+        // Вывод в консоль внутри параллельного цикла не выполняется, сообщения собираются и печатаются после
+        const Standard_Real zMin = segments.front()->getZStart();
+        const Standard_Real zMax = segments.back()->getZEnd();
+        OSD_Parallel::For(0, static_cast<Standard_Integer>(segmentCount), [&](Standard_Integer i) {
             try {
-                chamferMaker.Add(chamferDist, chamferDist, leftEdge,
-                                 TopoDS::Face(TopExp_Explorer(finalShape, TopAbs_FACE).Current()));
-                std::cout << "Chamfer added to left edge successfully" << std::endl;
+                pieces[i] = segments[i]->create();
             } catch (const Standard_Failure& e) {
-                std::cout << "Error adding chamfer to left edge: " << e.GetMessageString() << std::endl;
+                segmentErrors[i] = e.GetMessageString();
+                return;
+            } catch (const std::exception& e) {
+                segmentErrors[i] = e.what();
+                return;
             }
-        } else std::cout << "Warning: Left edge not found" << std::endl;
-        if (!rightEdge.IsNull()) {
-            try {
-                chamferMaker.Add(chamferDist, chamferDist, rightEdge,
-                                 TopoDS::Face(TopExp_Explorer(finalShape, TopAbs_FACE).Current()));
-                std::cout << "Chamfer added to right edge successfully" << std::endl;
-            } catch (const Standard_Failure& e) {
-                std::cout << "Error adding chamfer to right edge: " << e.GetMessageString() << std::endl;
+            // Торцевые фаски снимаются с крайних сегментов до объединения,
+            // поэтому их стоимость не зависит от числа сегментов
+            std::vector<Standard_Real> chamferZ;
+            if (i == 0) chamferZ.push_back(zMin);
+            if (static_cast<size_t>(i) == segmentCount - 1) chamferZ.push_back(zMax);
+            if (!chamferZ.empty()) {
+                try {
+                    pieces[i] = chamferEdgesAt(pieces[i], chamferZ);
+                } catch (const Standard_Failure& e) {
+                    segmentErrors[i] = std::string("end chamfers: ") + e.GetMessageString();
+                    return;
+                } catch (const std::exception& e) {
+                    segmentErrors[i] = std::string("end chamfers: ") + e.what();
+                    return;
+                }
             }
-        } else std::cout << "Warning: Right edge not found" << std::endl;
-        finalShape = chamferMaker.Shape();
-        std::cout << "Chamfers applied, preparing to cut slots" << std::endl;
+            if (!localSlots[i].empty()) pieces[i] = cutSlotsFrom(pieces[i], localSlots[i], featureErrors[i], false);
+        });
+
+        for (size_t i = 0; i < segmentCount; ++i) {
+            if (!segmentErrors[i].empty()) {
+                throw std::runtime_error("Error creating segment " + std::to_string(i) + ": " + segmentErrors[i]);
+            }
+            for (const std::string& message : featureErrors[i]) std::cout << message << std::endl;
+            if (!localSlots[i].empty()) {
+                std::cout << localSlots[i].size() << " slot(s) cut on segment " << i << std::endl;
+            }
+        }
+
+        finalShape = fuseSegments(pieces);
+        std::cout << "Segments fused successfully, end chamfers applied on end segments" << std::endl;
+        m_startFace.Nullify();
+        m_endFace.Nullify();
+        if (m_compaction) compact();
+        if (!globalSlots.empty()) {
+            std::cout << globalSlots.size() << " slot(s) cross segment bounds, cutting from the whole shaft" << std::endl;
+            cutSlots(globalSlots);
+        }
     }
 
-    void cutSlots() {
+    /**
+     * @brief Построение в исходном порядке, без ускорений
+     *
+     * Сегменты присоединяются к накопленному телу по одному, фаски снимаются с найденных
+     * по положению торцевых граней, пазы вырезаются по одному. Используется как эталон
+     * GoldenSuite, с которым сравниваются ускоренные режимы.
+     */
+    void buildSequential() {
+        finalShape = segments.front()->create();
+        for (size_t i = 1; i < segments.size(); ++i) {
+            BRepAlgoAPI_Fuse fuse(finalShape, segments[i]->create());
+            if (!fuse.IsDone()) throw std::runtime_error("Error fusing segment " + std::to_string(i));
+            finalShape = fuse.Shape();
+        }
+        std::cout << "Segments fused one by one" << std::endl;
+        m_startFace.Nullify();
+        m_endFace.Nullify();
+        if (m_compaction) compact();
+        finalShape = chamferEdgesAt(finalShape, {segments.front()->getZStart(), segments.back()->getZEnd()});
+        std::cout << "Chamfers applied, preparing to cut slots" << std::endl;
+        size_t cutCount = 0;
         for (size_t i = 0; i < m_slots.size(); ++i) {
             try {
-                // Создаем форму паза
-                TopoDS_Shape slotShape = m_slots[i].create();
-                // Вырезаем паз из вала
-                BRepAlgoAPI_Cut cut(finalShape, slotShape);
-                if (!cut.IsDone()) {
-                    throw std::runtime_error("Error cutting slot " + std::to_string(i));
-                }
-                finalShape = cut.Shape();
-                std::cout << "Slot " << i << " cut applied" << std::endl;
+                TopTools_ListOfShape tools;
+                tools.Append(m_slots[i].create());
+                finalShape = cutTools(finalShape, tools, false);
+                ++cutCount;
+            } catch (const Standard_Failure& e) {
+                std::cout << "Error cutting slot " << i << ": " << e.GetMessageString() << std::endl;
             } catch (const std::exception& e) {
                 std::cout << "Error cutting slot " << i << ": " << e.what() << std::endl;
             }
         }
+        std::cout << cutCount << " slot(s) cut one by one" << std::endl;
+    }
+
+    /**
+     * @brief Снять фаски с рёбер плоских торцевых граней тела в плоскостях Z = zValues
+     *
+     * Используется для отдельных сегментов, где граней немного.
+     */
+    TopoDS_Shape chamferEdgesAt(const TopoDS_Shape& shape, const std::vector<Standard_Real>& zValues) const {
+        std::vector<TopoDS_Face> faces;
+        for (Standard_Real z : zValues) {
+            faces.push_back(endFaceAt(shape, z));
+            if (faces.back().IsNull()) throw std::runtime_error("End face at Z=" + std::to_string(z) + " not found");
+        }
+        return chamferFaceEdges(shape, faces);
+    }
+
+    /**
+     * @brief Снять фаски со всех рёбер границы торцевых граней
+     *
+     * Берутся только рёбра самих граней: шов цилиндра касается торца вершиной,
+     * но снять на нём фаску нельзя.
+     */
+    TopoDS_Shape chamferFaceEdges(const TopoDS_Shape& shape, const std::vector<TopoDS_Face>& faces) const {
+        Standard_Real chamferDist = chamferLength * tan(chamferAngle * M_PI / 180.0);
+        BRepFilletAPI_MakeChamfer chamferMaker(shape);
+        TopTools_IndexedMapOfShape addedEdges;
+        try {
+            for (const TopoDS_Face& face : faces) {
+                for (TopExp_Explorer edgeExp(face, TopAbs_EDGE); edgeExp.More(); edgeExp.Next()) {
+                    if (addedEdges.Contains(edgeExp.Current())) continue;
+                    addedEdges.Add(edgeExp.Current());
+                    chamferMaker.Add(chamferDist, chamferDist, TopoDS::Edge(edgeExp.Current()), face);
+                }
+            }
+            chamferMaker.Build();
+        } catch (const Standard_Failure& e) {
+            throw std::runtime_error(std::string("Error adding end chamfers: ") + e.GetMessageString());
+        }
+        if (!chamferMaker.IsDone()) throw std::runtime_error("Error applying end chamfers");
+        return chamferMaker.Shape();
+    }
+
+    /**
+     * @brief Плоская грань тела, целиком лежащая в плоскости Z = z, или пустая грань
+     */
+    static TopoDS_Face endFaceAt(const TopoDS_Shape& shape, Standard_Real z) {
+        const Standard_Real tolerance = 1e-3;
+        for (TopExp_Explorer faceExp(shape, TopAbs_FACE); faceExp.More(); faceExp.Next()) {
+            const TopoDS_Face& face = TopoDS::Face(faceExp.Current());
+            if (BRepAdaptor_Surface(face, Standard_False).GetType() != GeomAbs_Plane) continue;
+            Bnd_Box box;
+            BRepBndLib::Add(face, box);
+            Standard_Real xMin, yMin, faceZMin, xMax, yMax, faceZMax;
+            box.Get(xMin, yMin, faceZMin, xMax, yMax, faceZMax);
+            if (faceZMin > z - tolerance && faceZMax < z + tolerance) return face;
+        }
+        return TopoDS_Face();
+    }
+
+    /**
+     * @brief Проверить, что инструмент паза целиком лежит внутри сегмента
+     */
+    static bool isSlotInsideSegment(const Slot& slot, const ShaftSegment& segment) {
+        const Standard_Real margin = 1e-6;
+        return slot.getZMin() > segment.getZStart() + margin && slot.getZMax() < segment.getZEnd() - margin;
+    }
+
+    /**
+     * @brief Объединить готовые части вала одной булевой операцией
+     * @param history Если задан, получает историю подформ (пустую для одной части)
+     */
+    static TopoDS_Shape fuseSegments(const std::vector<TopoDS_Shape>& pieces,
+                                     Handle(BRepTools_History)* history = nullptr) {
+        if (pieces.size() == 1) return pieces.front();
+        TopTools_ListOfShape arguments;
+        TopTools_ListOfShape tools;
+        arguments.Append(pieces.front());
+        for (size_t i = 1; i < pieces.size(); ++i) tools.Append(pieces[i]);
+        BRepAlgoAPI_Fuse fuse;
+        fuse.SetArguments(arguments);
+        fuse.SetTools(tools);
+        fuse.SetRunParallel(Standard_True);
+        fuse.Build();
+        if (!fuse.IsDone()) throw std::runtime_error("Error fusing shaft segments");
+        if (history) *history = fuse.History();
+        return fuse.Shape();
+    }
+
+    /**
+     * @brief Вырезать инструменты пазов одной операцией, не изменяя её аргументы
+     *
+     * Инструменты одинаковых пазов разделяют одну TShape из SlotToolCache и могут
+     * одновременно использоваться посегментными вырезами, поэтому операция
+     * выполняется в неразрушающем режиме.
+     */
+    static TopoDS_Shape cutTools(const TopoDS_Shape& shape, const TopTools_ListOfShape& tools, bool parallel) {
+        TopTools_ListOfShape arguments;
+        arguments.Append(shape);
+        BRepAlgoAPI_Cut cut;
+        cut.SetArguments(arguments);
+        cut.SetTools(tools);
+        cut.SetNonDestructive(Standard_True);
+        cut.SetRunParallel(parallel ? Standard_True : Standard_False);
+        cut.Build();
+        if (!cut.IsDone()) throw std::runtime_error("Boolean cut failed");
+        return cut.Shape();
+    }
+
+    /**
+     * @brief Вырезать пазы slotIndices из тела
+     *
+     * Все пазы вырезаются одной булевой операцией со списком инструментов: отдельный вырез
+     * каждого паза из всего вала заново пересекает растущее тело, и время растёт быстрее
+     * числа пазов. Если общий вырез не удался, пазы вырезаются по одному, чтобы ошибка
+     * относилась к конкретному пазу, а остальные пазы были построены.
+     * @param errors Сообщения об ошибках отдельных пазов
+     * @param parallel Распараллелить булеву операцию; внутри параллельного цикла по сегментам не нужно
+     */
+    TopoDS_Shape cutSlotsFrom(const TopoDS_Shape& shape, const std::vector<size_t>& slotIndices,
+                              std::vector<std::string>& errors, bool parallel) const {
+        std::vector<TopoDS_Shape> slotTools(slotIndices.size());
+        TopTools_ListOfShape tools;
+        try {
+            for (size_t k = 0; k < slotIndices.size(); ++k) {
+                slotTools[k] = m_slots[slotIndices[k]].create();
+                tools.Append(slotTools[k]);
+            }
+            return cutTools(shape, tools, parallel);
+        } catch (...) {
+            // Причину сбоя общего выреза уточняет вырез пазов по одному
+        }
+
+        TopoDS_Shape result = shape;
+        for (size_t k = 0; k < slotIndices.size(); ++k) {
+            const size_t slotIndex = slotIndices[k];
+            try {
+                if (slotTools[k].IsNull()) slotTools[k] = m_slots[slotIndex].create();
+                TopTools_ListOfShape single;
+                single.Append(slotTools[k]);
+                result = cutTools(result, single, parallel);
+            } catch (const Standard_Failure& e) {
+                errors.push_back("Error cutting slot " + std::to_string(slotIndex) + ": " + e.GetMessageString());
+            } catch (const std::exception& e) {
+                errors.push_back("Error cutting slot " + std::to_string(slotIndex) + ": " + e.what());
+            }
+        }
+        return result;
+    }
+
+    void cutSlots(const std::vector<size_t>& slotIndices) {
+        if (slotIndices.empty()) return;
+        std::vector<std::string> errors;
+        finalShape = cutSlotsFrom(finalShape, slotIndices, errors, true);
+        for (const std::string& message : errors) std::cout << message << std::endl;
+        std::cout << slotIndices.size() - errors.size() << " slot(s) cut" << std::endl;
     }
 };
 
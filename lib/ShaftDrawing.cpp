@@ -0,0 +1,405 @@
+#include "ShaftDrawing.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+namespace {
+
+const double textGap = 1.0;      // Отступ текста от размерной линии, мм
+const double arrowLength = 2.0;  // Длина стрелки, мм
+const double arrowWidth = 0.7;   // Полуширина стрелки, мм
+const double degrees = 180.0 / 3.14159265358979323846;
+
+const char* layerName(ShaftDrawing::Layer layer) {
+    switch (layer) {
+    case ShaftDrawing::Layer::Hidden: return "HIDDEN";
+    case ShaftDrawing::Layer::Center: return "CENTER";
+    case ShaftDrawing::Layer::Dimension: return "DIMENSIONS";
+    default: return "OUTLINE";
+    }
+}
+
+/**
+ * @brief Заменить коды DXF на символы UTF-8 для SVG и экранировать XML
+ */
+std::string svgText(const std::string& text) {
+    std::string result;
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text.compare(i, 3, "%%c") == 0) {
+            result += "\xC3\x98";
+            i += 2;
+        } else if (text.compare(i, 3, "%%d") == 0) {
+            result += "\xC2\xB0";
+            i += 2;
+        } else if (text[i] == '<') {
+            result += "&lt;";
+        } else if (text[i] == '>') {
+            result += "&gt;";
+        } else if (text[i] == '&') {
+            result += "&amp;";
+        } else {
+            result += text[i];
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Радиус сегмента на координате z (линейно для конуса)
+ */
+double radiusAt(const SegmentReadout& segment, double z) {
+    double r1 = segment.diameter / 2.0;
+    if (segment.type != "cone") return r1;
+    double r2 = segment.diameterEnd / 2.0;
+    return r1 + (r2 - r1) * (z - segment.zStart) / segment.length;
+}
+
+} // namespace
+
+ShaftDrawing::ShaftDrawing(const ShaftReadout& readout) : m_maxRadius(0.0) {
+    for (const SegmentReadout& segment : readout.segments) {
+        m_maxRadius = std::max(m_maxRadius, std::max(segment.diameter, segment.diameterEnd) / 2.0);
+    }
+    addSideView(readout);
+    addDimensions(readout);
+    addSlotSections(readout);
+}
+
+void ShaftDrawing::addSideView(const ShaftReadout& readout) {
+    const std::vector<SegmentReadout>& segments = readout.segments;
+    if (segments.empty()) return;
+    const double chamfer = readout.chamferLength;
+    const double length = readout.totalLength;
+
+    // Осевая линия
+    addLine(-5.0, 0.0, length + 5.0, 0.0, Layer::Center);
+
+    for (size_t i = 0; i < segments.size(); ++i) {
+        const SegmentReadout& segment = segments[i];
+        double z0 = segment.zStart;
+        double z1 = segment.zEnd();
+        if (i == 0) z0 += chamfer;
+        if (i == segments.size() - 1) z1 -= chamfer;
+
+        // Верхний контур прерывается над пазами: там видна кромка паза
+        std::vector<std::pair<double, double>> cuts;
+        for (const SlotReadout& slot : readout.slotDetails) {
+            if (static_cast<size_t>(slot.segmentIndex) != i || segment.type == "cone") continue;
+            cuts.push_back({slot.zStart - slot.width / 2.0, slot.zStart + slot.length + slot.width / 2.0});
+        }
+        std::sort(cuts.begin(), cuts.end());
+        double z = z0;
+        for (const auto& cut : cuts) {
+            double from = std::max(cut.first, z0);
+            double to = std::min(cut.second, z1);
+            if (from > z) addLine(z, radiusAt(segment, z), from, radiusAt(segment, from));
+            z = std::max(z, to);
+        }
+        if (z < z1) addLine(z, radiusAt(segment, z), z1, radiusAt(segment, z1));
+        addLine(z0, -radiusAt(segment, z0), z1, -radiusAt(segment, z1));
+
+        // Ступень: линия видимого торца большего диаметра
+        if (i + 1 < segments.size()) {
+            double rEnd = radiusAt(segment, segment.zEnd());
+            double rNext = segments[i + 1].diameter / 2.0;
+            if (std::fabs(rEnd - rNext) > 1e-9) {
+                double r = std::max(rEnd, rNext);
+                addLine(segment.zEnd(), -r, segment.zEnd(), r);
+            }
+        }
+    }
+
+    // Торцы с фасками 45°
+    double rLeft = segments.front().diameter / 2.0;
+    addLine(0.0, -(rLeft - chamfer), 0.0, rLeft - chamfer);
+    addLine(0.0, rLeft - chamfer, chamfer, rLeft);
+    addLine(0.0, -(rLeft - chamfer), chamfer, -rLeft);
+    addLine(chamfer, -rLeft, chamfer, rLeft);
+    const SegmentReadout& last = segments.back();
+    double rRight = radiusAt(last, last.zEnd());
+    addLine(length, -(rRight - chamfer), length, rRight - chamfer);
+    addLine(length, rRight - chamfer, length - chamfer, rRight);
+    addLine(length, -(rRight - chamfer), length - chamfer, -rRight);
+    addLine(length - chamfer, -rRight, length - chamfer, rRight);
+
+    // Пазы: над пазом контур проходит по кромке стенок, у скруглённых концов кромка поднимается
+    // до образующей вала, замыкая контур. Дно и торцы паза закрыты стенкой со стороны
+    // наблюдателя и показываются невидимыми линиями от дна до образующей
+    const int endSteps = 8;
+    for (const SlotReadout& slot : readout.slotDetails) {
+        double radius = slot.hostDiameter / 2.0;
+        if (slot.width >= slot.hostDiameter || slot.depth > radius) continue;
+        double halfWidth = slot.width / 2.0;
+        double zMin = slot.zStart - halfWidth;
+        double zMax = slot.zStart + slot.length + halfWidth;
+        double bottom = radius - slot.depth;
+        // Высота кромки там, где полуширина паза в плане равна h; ниже дна кромки нет
+        auto edgeAt = [&](double h) { return std::max(std::sqrt(radius * radius - h * h), bottom); };
+        for (int k = 0; k < endSteps; ++k) {
+            double a0 = halfWidth * k / endSteps;
+            double a1 = halfWidth * (k + 1) / endSteps;
+            double h0 = std::sqrt(halfWidth * halfWidth - (halfWidth - a0) * (halfWidth - a0));
+            double h1 = std::sqrt(halfWidth * halfWidth - (halfWidth - a1) * (halfWidth - a1));
+            addLine(zMin + a0, edgeAt(h0), zMin + a1, edgeAt(h1));
+            addLine(zMax - a0, edgeAt(h0), zMax - a1, edgeAt(h1));
+        }
+        double edge = edgeAt(halfWidth);
+        addLine(zMin + halfWidth, edge, zMax - halfWidth, edge);
+        if (bottom >= edge) continue;
+        addLine(zMin, bottom, zMax, bottom, Layer::Hidden);
+        addLine(zMin, bottom, zMin, radius, Layer::Hidden);
+        addLine(zMax, bottom, zMax, radius, Layer::Hidden);
+    }
+}
+
+void ShaftDrawing::addDimensions(const ShaftReadout& readout) {
+    const std::vector<SegmentReadout>& segments = readout.segments;
+    if (segments.empty()) return;
+
+    // Цепочка длин сегментов и общая длина под видом
+    const double chainY = -m_maxRadius - 8.0;
+    for (const SegmentReadout& segment : segments) {
+        addHorizontalDimension(segment.zStart, -radiusAt(segment, segment.zStart),
+                               segment.zEnd(), -radiusAt(segment, segment.zEnd()), chainY, number(segment.length));
+    }
+    addHorizontalDimension(0.0, chainY, readout.totalLength, chainY, chainY - 8.0, number(readout.totalLength));
+
+    // Диаметры ступеней
+    for (const SegmentReadout& segment : segments) {
+        double middle = segment.zStart + segment.length / 2.0;
+        double r = radiusAt(segment, middle);
+        std::string text = "%%c" + number(segment.diameter);
+        if (segment.type == "cone") text += "/%%c" + number(segment.diameterEnd);
+        addVerticalDimension(middle, -r, middle, r, middle, text);
+    }
+
+    // Фаски
+    addText(0.0, segments.front().diameter / 2.0 + 4.0, number(readout.chamferLength) + "x45%%d");
+    const SegmentReadout& last = segments.back();
+    addText(readout.totalLength, radiusAt(last, last.zEnd()) + 4.0, number(readout.chamferLength) + "x45%%d");
+
+    // Положение и длина пазов над видом
+    const double slotY = m_maxRadius + 8.0;
+    for (const SlotReadout& slot : readout.slotDetails) {
+        double radius = slot.hostDiameter / 2.0;
+        double zMin = slot.zStart - slot.width / 2.0;
+        double zMax = slot.zStart + slot.length + slot.width / 2.0;
+        addHorizontalDimension(zMin, radius, zMax, radius, slotY, number(zMax - zMin));
+        addHorizontalDimension(0.0, 0.0, zMin, radius, slotY + 8.0, number(zMin));
+    }
+}
+
+void ShaftDrawing::addSlotSections(const ShaftReadout& readout) {
+    // Одинаковые пазы показываются одним сечением
+    std::vector<const SlotReadout*> unique;
+    for (const SlotReadout& slot : readout.slotDetails) {
+        if (slot.width >= slot.hostDiameter || slot.depth > slot.hostDiameter / 2.0) continue;
+        bool seen = false;
+        for (const SlotReadout* other : unique) {
+            if (std::fabs(other->width - slot.width) < 1e-9 && std::fabs(other->depth - slot.depth) < 1e-9 &&
+                std::fabs(other->hostDiameter - slot.hostDiameter) < 1e-9) {
+                seen = true;
+                break;
+            }
+        }
+        if (!seen) unique.push_back(&slot);
+    }
+
+    double cx = 0.0;
+    const double cy = -3.0 * m_maxRadius - 40.0;
+    for (size_t i = 0; i < unique.size(); ++i) {
+        const SlotReadout& slot = *unique[i];
+        double radius = slot.hostDiameter / 2.0;
+        double halfWidth = slot.width / 2.0;
+        double bottom = radius - slot.depth;
+        double edge = std::sqrt(radius * radius - halfWidth * halfWidth);
+        cx += (i == 0 ? radius : 2.0 * radius + 30.0);
+
+        double angle = std::atan2(edge, halfWidth) * degrees;
+        m_arcs.push_back(Arc{cx, cy, radius, 180.0 - angle, angle, Layer::Outline});
+        addLine(cx - halfWidth, cy + edge, cx - halfWidth, cy + bottom);
+        addLine(cx - halfWidth, cy + bottom, cx + halfWidth, cy + bottom);
+        addLine(cx + halfWidth, cy + bottom, cx + halfWidth, cy + edge);
+        addLine(cx - radius - 3.0, cy, cx + radius + 3.0, cy, Layer::Center);
+        addLine(cx, cy - radius - 3.0, cx, cy + radius + 3.0, Layer::Center);
+
+        std::string name(1, static_cast<char>('A' + i % 26));
+        addText(cx, cy - radius - 8.0, name + "-" + name, 0.0, 3.5);
+        addHorizontalDimension(cx - halfWidth, cy + edge, cx + halfWidth, cy + edge, cy + radius + 6.0,
+                               number(slot.width));
+        addVerticalDimension(cx + halfWidth, cy + bottom, cx, cy - radius, cx + radius + 6.0,
+                             number(2.0 * radius - slot.depth));
+
+        // Метка сечения над пазами этого вида
+        for (const SlotReadout& other : readout.slotDetails) {
+            if (std::fabs(other.width - slot.width) < 1e-9 && std::fabs(other.depth - slot.depth) < 1e-9 &&
+                std::fabs(other.hostDiameter - slot.hostDiameter) < 1e-9) {
+                addText(other.zStart + other.length / 2.0, other.hostDiameter / 2.0 + 3.0, name, 0.0, 3.5);
+            }
+        }
+    }
+}
+
+void ShaftDrawing::addHorizontalDimension(double x1, double y1, double x2, double y2, double yDim,
+                                          const std::string& text) {
+    double direction = yDim >= std::max(y1, y2) ? 1.0 : -1.0;
+    addLine(x1, y1, x1, yDim + direction, Layer::Dimension);
+    addLine(x2, y2, x2, yDim + direction, Layer::Dimension);
+    addLine(x1, yDim, x2, yDim, Layer::Dimension);
+    double arrow = std::min(arrowLength, std::fabs(x2 - x1) / 2.0);
+    double sign = x2 >= x1 ? 1.0 : -1.0;
+    addLine(x1, yDim, x1 + sign * arrow, yDim + arrowWidth, Layer::Dimension);
+    addLine(x1, yDim, x1 + sign * arrow, yDim - arrowWidth, Layer::Dimension);
+    addLine(x2, yDim, x2 - sign * arrow, yDim + arrowWidth, Layer::Dimension);
+    addLine(x2, yDim, x2 - sign * arrow, yDim - arrowWidth, Layer::Dimension);
+    addText((x1 + x2) / 2.0, yDim + textGap + 1.25, text);
+}
+
+void ShaftDrawing::addVerticalDimension(double x1, double y1, double x2, double y2, double xDim,
+                                        const std::string& text) {
+    if (std::fabs(x1 - xDim) > 1e-9) addLine(x1, y1, xDim + 1.0, y1, Layer::Dimension);
+    if (std::fabs(x2 - xDim) > 1e-9) addLine(x2, y2, xDim + 1.0, y2, Layer::Dimension);
+    addLine(xDim, y1, xDim, y2, Layer::Dimension);
+    double arrow = std::min(arrowLength, std::fabs(y2 - y1) / 2.0);
+    double sign = y2 >= y1 ? 1.0 : -1.0;
+    addLine(xDim, y1, xDim + arrowWidth, y1 + sign * arrow, Layer::Dimension);
+    addLine(xDim, y1, xDim - arrowWidth, y1 + sign * arrow, Layer::Dimension);
+    addLine(xDim, y2, xDim + arrowWidth, y2 - sign * arrow, Layer::Dimension);
+    addLine(xDim, y2, xDim - arrowWidth, y2 - sign * arrow, Layer::Dimension);
+    addText(xDim - textGap - 1.25, (y1 + y2) / 2.0, text, 90.0);
+}
+
+std::string ShaftDrawing::number(double value) {
+    std::ostringstream text;
+    text.setf(std::ios::fixed);
+    text.precision(3);
+    text << value;
+    std::string result = text.str();
+    // Незначащие нули не пишутся: 23.000 -> 23, 8.500 -> 8.5
+    while (!result.empty() && result.back() == '0') result.pop_back();
+    if (!result.empty() && result.back() == '.') result.pop_back();
+    return result;
+}
+
+void ShaftDrawing::writeSVG(std::ostream& output) const {
+    double minX = std::numeric_limits<double>::max();
+    double minY = minX;
+    double maxX = -minX;
+    double maxY = -minX;
+    auto extend = [&](double x, double y) {
+        minX = std::min(minX, x);
+        maxX = std::max(maxX, x);
+        minY = std::min(minY, y);
+        maxY = std::max(maxY, y);
+    };
+    for (const Line& line : m_lines) {
+        extend(line.x1, line.y1);
+        extend(line.x2, line.y2);
+    }
+    for (const Arc& arc : m_arcs) {
+        extend(arc.cx - arc.radius, arc.cy - arc.radius);
+        extend(arc.cx + arc.radius, arc.cy + arc.radius);
+    }
+    for (const Text& text : m_texts) extend(text.x, text.y);
+    if (minX > maxX) {
+        minX = minY = 0.0;
+        maxX = maxY = 1.0;
+    }
+    const double margin = 10.0;
+    minX -= margin;
+    minY -= margin;
+    maxX += margin;
+    maxY += margin;
+
+    // Точность по умолчанию (6 значащих цифр) огрубляет координаты длинного вала
+    const std::streamsize previousPrecision = output.precision(12);
+    // В SVG ось Y направлена вниз, поэтому координаты Y меняют знак
+    output << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+           << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"" << maxX - minX << "mm\" height=\"" << maxY - minY
+           << "mm\" viewBox=\"" << minX << ' ' << -maxY << ' ' << maxX - minX << ' ' << maxY - minY << "\">\n"
+           << "<style>line,path{fill:none;stroke:#000;stroke-linecap:round}"
+           << ".OUTLINE{stroke-width:0.5}.HIDDEN{stroke-width:0.25;stroke-dasharray:3 1.5}"
+           << ".CENTER{stroke-width:0.25;stroke-dasharray:8 1.5 1 1.5}.DIMENSIONS{stroke-width:0.18}"
+           << "text{font-family:sans-serif;text-anchor:middle;dominant-baseline:central}</style>\n";
+    for (const Line& line : m_lines) {
+        output << "<line class=\"" << layerName(line.layer) << "\" x1=\"" << line.x1 << "\" y1=\"" << -line.y1
+               << "\" x2=\"" << line.x2 << "\" y2=\"" << -line.y2 << "\"/>\n";
+    }
+    for (const Arc& arc : m_arcs) {
+        double start = arc.startAngle / degrees;
+        double end = arc.endAngle / degrees;
+        double sweep = std::fmod(arc.endAngle - arc.startAngle + 360.0, 360.0);
+        output << "<path class=\"" << layerName(arc.layer) << "\" d=\"M " << arc.cx + arc.radius * std::cos(start)
+               << ' ' << -(arc.cy + arc.radius * std::sin(start)) << " A " << arc.radius << ' ' << arc.radius
+               << " 0 " << (sweep > 180.0 ? 1 : 0) << " 0 " << arc.cx + arc.radius * std::cos(end) << ' '
+               << -(arc.cy + arc.radius * std::sin(end)) << "\"/>\n";
+    }
+    for (const Text& text : m_texts) {
+        output << "<text x=\"" << text.x << "\" y=\"" << -text.y << "\" font-size=\"" << text.height << "\"";
+        if (text.rotation != 0.0) {
+            output << " transform=\"rotate(" << -text.rotation << ' ' << text.x << ' ' << -text.y << ")\"";
+        }
+        output << '>' << svgText(text.text) << "</text>\n";
+    }
+    output << "</svg>\n";
+    output.precision(previousPrecision);
+}
+
+void ShaftDrawing::writeDXF(std::ostream& output) const {
+    // DXF R12: таблицы типов линий и слоёв, затем примитивы. Единицы ($INSUNITS) появились
+    // только в R2000, в R12 координаты принимаются в мм по соглашению
+    const std::streamsize previousPrecision = output.precision(12);
+    output << "0\nSECTION\n2\nHEADER\n9\n$ACADVER\n1\nAC1009\n0\nENDSEC\n"
+           << "0\nSECTION\n2\nTABLES\n"
+           << "0\nTABLE\n2\nLTYPE\n70\n3\n"
+           << "0\nLTYPE\n2\nCONTINUOUS\n70\n0\n3\nSolid line\n72\n65\n73\n0\n40\n0.0\n"
+           << "0\nLTYPE\n2\nHIDDEN\n70\n0\n3\n__ __ __\n72\n65\n73\n2\n40\n4.5\n49\n3.0\n49\n-1.5\n"
+           << "0\nLTYPE\n2\nCENTER\n70\n0\n3\n____ _ ____\n72\n65\n73\n4\n40\n12.0\n49\n8.0\n49\n-1.5\n49\n1.0\n49\n-1.5\n"
+           << "0\nENDTAB\n"
+           << "0\nTABLE\n2\nLAYER\n70\n4\n"
+           << "0\nLAYER\n2\nOUTLINE\n70\n0\n62\n7\n6\nCONTINUOUS\n"
+           << "0\nLAYER\n2\nHIDDEN\n70\n0\n62\n8\n6\nHIDDEN\n"
+           << "0\nLAYER\n2\nCENTER\n70\n0\n62\n1\n6\nCENTER\n"
+           << "0\nLAYER\n2\nDIMENSIONS\n70\n0\n62\n3\n6\nCONTINUOUS\n"
+           << "0\nENDTAB\n0\nENDSEC\n"
+           << "0\nSECTION\n2\nENTITIES\n";
+    for (const Line& line : m_lines) {
+        output << "0\nLINE\n8\n" << layerName(line.layer)
+               << "\n10\n" << line.x1 << "\n20\n" << line.y1 << "\n30\n0.0"
+               << "\n11\n" << line.x2 << "\n21\n" << line.y2 << "\n31\n0.0\n";
+    }
+    for (const Arc& arc : m_arcs) {
+        output << "0\nARC\n8\n" << layerName(arc.layer)
+               << "\n10\n" << arc.cx << "\n20\n" << arc.cy << "\n30\n0.0"
+               << "\n40\n" << arc.radius << "\n50\n" << arc.startAngle << "\n51\n" << arc.endAngle << "\n";
+    }
+    for (const Text& text : m_texts) {
+        output << "0\nTEXT\n8\nDIMENSIONS"
+               << "\n10\n" << text.x << "\n20\n" << text.y << "\n30\n0.0"
+               << "\n40\n" << text.height << "\n1\n" << text.text << "\n50\n" << text.rotation
+               << "\n72\n1\n11\n" << text.x << "\n21\n" << text.y << "\n31\n0.0\n73\n2\n";
+    }
+    output << "0\nENDSEC\n0\nEOF\n";
+    output.precision(previousPrecision);
+}
+
+bool ShaftDrawing::save(const std::string& filename) const {
+    std::string extension = filename.size() >= 4 ? filename.substr(filename.size() - 4) : std::string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    std::ofstream output(filename, std::ios::binary);
+    if (!output) {
+        std::cerr << "Error: cannot open drawing file " << filename << std::endl;
+        return false;
+    }
+    if (extension == ".dxf") {
+        writeDXF(output);
+    } else {
+        writeSVG(output);
+    }
+    return static_cast<bool>(output);
+}
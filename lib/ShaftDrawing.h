@@ -0,0 +1,69 @@
+/**
+ * @file ShaftDrawing.h
+ * @brief Построение 2D чертежа вала (вид сбоку, сечения пазов, размеры) по аналитическому профилю
+ */
+
+#ifndef SHAFT_DRAWING_H
+#define SHAFT_DRAWING_H
+
+#include "ShaftAnalysis.h"
+#include <string>
+#include <vector>
+#include <ostream>
+
+/**
+ * @class ShaftDrawing
+ * @brief Чертёж вала в векторном виде с выводом в SVG и DXF
+ *
+ * Контур, ступени, конус, фаски и пазы берутся из ShaftReadout, поэтому чертёж
+ * строится без B-rep и удаления невидимых линий. Координаты чертежа в мм:
+ * ось X совпадает с осью вала (Z модели), ось Y направлена к пазам.
+ */
+class ShaftDrawing {
+public:
+    enum class Layer { Outline, Hidden, Center, Dimension };
+
+    explicit ShaftDrawing(const ShaftReadout& readout);
+
+    static ShaftDrawing fromProportions(const ShaftProportions& proportions) {
+        return ShaftDrawing(ShaftAnalysis::analyze(proportions));
+    }
+
+    void writeSVG(std::ostream& output) const;
+    void writeDXF(std::ostream& output) const;
+
+    /**
+     * @brief Записать чертёж в файл; формат выбирается по расширению (.svg или .dxf)
+     * @return true при успехе
+     */
+    bool save(const std::string& filename) const;
+
+private:
+    struct Line { double x1, y1, x2, y2; Layer layer; };
+    // Дуга против часовой стрелки от startAngle до endAngle, градусы
+    struct Arc { double cx, cy, radius, startAngle, endAngle; Layer layer; };
+    // Текст центрируется по точке; %%c - знак диаметра, %%d - знак градуса (как в DXF)
+    struct Text { double x, y, height, rotation; std::string text; };
+
+    void addSideView(const ShaftReadout& readout);
+    void addSlotSections(const ShaftReadout& readout);
+    void addDimensions(const ShaftReadout& readout);
+
+    void addLine(double x1, double y1, double x2, double y2, Layer layer = Layer::Outline) {
+        m_lines.push_back(Line{x1, y1, x2, y2, layer});
+    }
+    void addText(double x, double y, const std::string& text, double rotation = 0.0, double height = 2.5) {
+        m_texts.push_back(Text{x, y, height, rotation, text});
+    }
+    void addHorizontalDimension(double x1, double y1, double x2, double y2, double yDim, const std::string& text);
+    void addVerticalDimension(double x1, double y1, double x2, double y2, double xDim, const std::string& text);
+
+    static std::string number(double value);
+
+    std::vector<Line> m_lines;
+    std::vector<Arc> m_arcs;
+    std::vector<Text> m_texts;
+    double m_maxRadius;
+};
+
+#endif // SHAFT_DRAWING_H
@@ -0,0 +1,394 @@
+#include "ShaftFits.h"
+#include "ShaftAnalysis.h"
+#include <OSD_Parallel.hxx>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+// Интервалы номинальных размеров ISO 286: (0, 3], (3, 6], ..., (80, 120]
+const double sizeSteps[] = {3.0, 6.0, 10.0, 18.0, 30.0, 50.0, 80.0, 120.0};
+const int sizeStepCount = 8;
+
+// Допуски IT4-IT11, мкм; IT4 нужен только для поправки Δ отверстий квалитета 5
+const double standardTolerances[8][sizeStepCount] = {
+    {3, 4, 4, 5, 6, 7, 8, 10},
+    {4, 5, 6, 8, 9, 11, 13, 15},
+    {6, 8, 9, 11, 13, 16, 19, 22},
+    {10, 12, 15, 18, 21, 25, 30, 35},
+    {14, 18, 22, 27, 33, 39, 46, 54},
+    {25, 30, 36, 43, 52, 62, 74, 87},
+    {40, 48, 58, 70, 84, 100, 120, 140},
+    {60, 75, 90, 110, 130, 160, 190, 220}};
+
+// Основные отклонения валов, мкм: верхние для f, g, нижние для k (IT4-IT7), m, n, p
+const double deviationF[sizeStepCount] = {-6, -10, -13, -16, -20, -25, -30, -36};
+const double deviationG[sizeStepCount] = {-2, -4, -5, -6, -7, -9, -10, -12};
+const double deviationK[sizeStepCount] = {0, 1, 1, 1, 2, 2, 2, 3};
+const double deviationM[sizeStepCount] = {2, 4, 6, 7, 8, 9, 11, 13};
+const double deviationN[sizeStepCount] = {4, 8, 10, 12, 15, 17, 20, 23};
+const double deviationP[sizeStepCount] = {6, 12, 15, 18, 22, 26, 32, 37};
+
+// Шпонки призматические ISO 773: диаметр вала (dMin, dMax], b x h, t1, t2
+const KeySpec defaultKeys[] = {
+    {10, 12, 4, 4, 2.5, 1.8},   {12, 17, 5, 5, 3.0, 2.3},   {17, 22, 6, 6, 3.5, 2.8},
+    {22, 30, 8, 7, 4.0, 3.3},   {30, 38, 10, 8, 5.0, 3.3},  {38, 44, 12, 8, 5.0, 3.3},
+    {44, 50, 14, 9, 5.5, 3.8},  {50, 58, 16, 10, 6.0, 4.3}, {58, 65, 18, 11, 7.0, 4.4}};
+
+// Зазор, меньший по модулю, считается нулевым: H/h на одном номинале даёт ровно 0
+const double clearanceEpsilon = 1e-9;
+
+int sizeStep(double nominal) {
+    if (nominal <= 0.0) throw std::invalid_argument("nominal size must be positive");
+    for (int i = 0; i < sizeStepCount; ++i) {
+        if (nominal <= sizeSteps[i]) return i;
+    }
+    throw std::out_of_range("ISO 286 tables cover sizes up to 120 mm, got " + std::to_string(nominal));
+}
+
+std::string formatSize(double value) {
+    std::ostringstream text;
+    text << value;
+    return text.str();
+}
+
+} // namespace
+
+ToleranceClass ToleranceClass::parse(const std::string& text) {
+    ToleranceClass tolerance;
+    tolerance.m_name = text;
+    const size_t slash = text.find('/');
+    if (slash != std::string::npos) {
+        tolerance.m_lower = std::stod(text.substr(0, slash));
+        tolerance.m_upper = std::stod(text.substr(slash + 1));
+        if (tolerance.m_lower > tolerance.m_upper) {
+            throw std::invalid_argument("lower deviation exceeds upper in " + text);
+        }
+        return tolerance;
+    }
+
+    size_t digits = 0;
+    while (digits < text.size() && std::isalpha(static_cast<unsigned char>(text[digits]))) ++digits;
+    if (digits == 0 || digits == text.size()) throw std::invalid_argument("invalid tolerance class " + text);
+    tolerance.m_hole = std::isupper(static_cast<unsigned char>(text[0])) != 0;
+    for (size_t i = 0; i < digits; ++i) {
+        tolerance.m_letter += static_cast<char>(std::tolower(static_cast<unsigned char>(text[i])));
+    }
+    static const char* letters[] = {"f", "g", "h", "js", "k", "m", "n", "p"};
+    if (std::find_if(std::begin(letters), std::end(letters),
+                     [&](const char* letter) { return tolerance.m_letter == letter; }) == std::end(letters)) {
+        throw std::invalid_argument("unsupported fundamental deviation in " + text);
+    }
+    tolerance.m_grade = std::stoi(text.substr(digits));
+    if (tolerance.m_grade < 5 || tolerance.m_grade > 11) {
+        throw std::invalid_argument("tolerance grade must be IT5-IT11 in " + text);
+    }
+    return tolerance;
+}
+
+double ToleranceClass::standardTolerance(int grade, double nominal) {
+    if (grade < 4 || grade > 11) throw std::out_of_range("tolerance grade IT" + std::to_string(grade) + " is not tabulated");
+    return standardTolerances[grade - 4][sizeStep(nominal)];
+}
+
+void ToleranceClass::deviations(double nominal, double& lower, double& upper) const {
+    if (m_letter.empty()) {
+        lower = m_lower;
+        upper = m_upper;
+        return;
+    }
+    const int step = sizeStep(nominal);
+    const double it = standardTolerances[m_grade - 4][step];
+    double lowerMicrons = 0.0;
+    double upperMicrons = 0.0;
+
+    if (m_letter == "js") {
+        lowerMicrons = -it / 2.0;
+        upperMicrons = it / 2.0;
+    } else if (!m_hole) {
+        if (m_letter == "f") upperMicrons = deviationF[step];
+        else if (m_letter == "g") upperMicrons = deviationG[step];
+        else if (m_letter == "h") upperMicrons = 0.0;
+        else if (m_letter == "k") lowerMicrons = m_grade <= 7 ? deviationK[step] : 0.0;
+        else if (m_letter == "m") lowerMicrons = deviationM[step];
+        else if (m_letter == "n") lowerMicrons = deviationN[step];
+        else lowerMicrons = deviationP[step];
+        if (m_letter == "f" || m_letter == "g" || m_letter == "h") lowerMicrons = upperMicrons - it;
+        else upperMicrons = lowerMicrons + it;
+    } else if (m_letter == "f" || m_letter == "g" || m_letter == "h") {
+        // F, G, H симметричны валам: EI = -es
+        lowerMicrons = m_letter == "f" ? -deviationF[step] : m_letter == "g" ? -deviationG[step] : 0.0;
+        upperMicrons = lowerMicrons + it;
+    } else {
+        // K, M, N, P: ES = -ei + Δ для точных квалитетов, Δ = IT(n) - IT(n-1), для размеров до 3 мм Δ = 0
+        const double delta = step == 0 ? 0.0 : it - standardTolerances[m_grade - 5][step];
+        if (m_letter == "k") upperMicrons = m_grade <= 8 ? -deviationK[step] + delta : 0.0;
+        else if (m_letter == "m") upperMicrons = -deviationM[step] + (m_grade <= 8 ? delta : 0.0);
+        else if (m_letter == "n") upperMicrons = m_grade <= 8 ? -deviationN[step] + delta : (step == 0 ? -deviationN[step] : 0.0);
+        else upperMicrons = -deviationP[step] + (m_grade <= 7 ? delta : 0.0);
+        lowerMicrons = upperMicrons - it;
+    }
+    lower = lowerMicrons / 1000.0;
+    upper = upperMicrons / 1000.0;
+}
+
+void FitCatalogue::setKeyFit(const ToleranceClass& keyTolerance, const ToleranceClass& slotTolerance, FitKind required) {
+    m_keyTolerance = keyTolerance;
+    m_slotTolerance = slotTolerance;
+    m_keyFit = required;
+}
+
+const MatingBore* FitCatalogue::findBore(const std::string& kind, double diameter) const {
+    const MatingBore* sized = nullptr;
+    for (const MatingBore& bore : m_bores) {
+        if (bore.kind != kind) continue;
+        if (bore.diameter <= 0.0) {
+            if (!sized) sized = &bore;
+        } else if (std::abs(bore.diameter - diameter) < 1e-6) {
+            return &bore;
+        }
+    }
+    return sized;
+}
+
+const KeySpec* FitCatalogue::findKey(double shaftDiameter) const {
+    for (const KeySpec& key : m_keys) {
+        if (shaftDiameter > key.shaftMin && shaftDiameter <= key.shaftMax) return &key;
+    }
+    return nullptr;
+}
+
+const char* FitCatalogue::kindName(FitKind kind) {
+    switch (kind) {
+    case FitKind::Transition: return "transition";
+    case FitKind::Interference: return "interference";
+    default: return "clearance";
+    }
+}
+
+FitKind FitCatalogue::parseKind(const std::string& name) {
+    if (name == "clearance") return FitKind::Clearance;
+    if (name == "transition") return FitKind::Transition;
+    if (name == "interference") return FitKind::Interference;
+    throw std::invalid_argument("unknown fit kind " + name);
+}
+
+FitCatalogue FitCatalogue::defaultCatalogue() {
+    FitCatalogue catalogue;
+    // Внутреннее кольцо подшипника класса точности 0 (до 30 мм: 0/-10 мкм) и ступица H7
+    catalogue.addBore(MatingBore{"bearing", "bearing", 0.0, ToleranceClass::parse("-0.01/0")});
+    catalogue.addBore(MatingBore{"hub", "hub", 0.0, ToleranceClass::parse("H7")});
+    for (const KeySpec& key : defaultKeys) catalogue.addKey(key);
+    catalogue.addSeat(SeatRule{3, ToleranceClass::parse("k6"), "bearing", -1, FitKind::Interference});
+    catalogue.addSeat(SeatRule{9, ToleranceClass::parse("m6"), "hub", -1, FitKind::Transition});
+    catalogue.addSeat(SeatRule{2, ToleranceClass::parse("h11"), "bearing", 3, FitKind::Clearance});
+    catalogue.addSeat(SeatRule{4, ToleranceClass::parse("h11"), "bearing", 3, FitKind::Clearance});
+    catalogue.addSeat(SeatRule{8, ToleranceClass::parse("h11"), "hub", 9, FitKind::Clearance});
+    return catalogue;
+}
+
+FitCatalogue FitCatalogue::load(const std::string& filename) {
+    std::ifstream input(filename);
+    if (!input) throw std::runtime_error("Cannot open fit catalogue " + filename);
+
+    FitCatalogue catalogue;
+    std::string line;
+    size_t lineNumber = 0;
+    while (std::getline(input, line)) {
+        ++lineNumber;
+        std::istringstream fields(line);
+        std::string record;
+        if (!(fields >> record) || record[0] == '#') continue;
+        try {
+            if (record == "bore") {
+                std::string kind, name, diameter, tolerance;
+                if (!(fields >> kind >> name >> diameter >> tolerance)) throw std::invalid_argument("expected kind, name, diameter and tolerance");
+                catalogue.addBore(MatingBore{kind, name, diameter == "*" ? 0.0 : std::stod(diameter), ToleranceClass::parse(tolerance)});
+            } else if (record == "key") {
+                KeySpec key;
+                if (!(fields >> key.shaftMin >> key.shaftMax >> key.width >> key.height >> key.shaftDepth >> key.hubDepth)) {
+                    throw std::invalid_argument("expected dMin, dMax, b, h, t1 and t2");
+                }
+                catalogue.addKey(key);
+            } else if (record == "keyfit") {
+                std::string keyTolerance, slotTolerance, required;
+                if (!(fields >> keyTolerance >> slotTolerance >> required)) throw std::invalid_argument("expected key, slot tolerances and fit");
+                catalogue.setKeyFit(ToleranceClass::parse(keyTolerance), ToleranceClass::parse(slotTolerance), parseKind(required));
+            } else if (record == "seat") {
+                int segment = 0;
+                std::string shaftTolerance, kind, mating, required;
+                if (!(fields >> segment >> shaftTolerance >> kind >> mating >> required)) {
+                    throw std::invalid_argument("expected segment, tolerance, kind, mating segment and fit");
+                }
+                catalogue.addSeat(SeatRule{segment, ToleranceClass::parse(shaftTolerance), kind,
+                                           mating == "-" ? -1 : std::stoi(mating), parseKind(required)});
+            } else {
+                throw std::invalid_argument("unknown record " + record);
+            }
+        } catch (const std::exception& e) {
+            throw std::runtime_error("Malformed catalogue entry at line " + std::to_string(lineNumber) + " of " +
+                                     filename + ": " + e.what());
+        }
+    }
+    return catalogue;
+}
+
+size_t FitReport::validCount() const {
+    return static_cast<size_t>(std::count(variantValid.begin(), variantValid.end(), 1));
+}
+
+void FitReport::print(std::ostream& output, const std::vector<std::string>& names, bool failuresOnly) const {
+    output << "Fit check: " << validCount() << " of " << variantCount << " variants valid, " << results.size()
+           << " fits in " << seconds << " s" << std::endl;
+    for (const FitResult& result : results) {
+        if (failuresOnly && result.isValid()) continue;
+        output << "  " << (result.variant < names.size() ? names[result.variant] : "#" + std::to_string(result.variant + 1))
+               << ": " << result.feature << ": ";
+        if (!result.error.empty()) {
+            output << "ERROR " << result.error << std::endl;
+            continue;
+        }
+        output << FitCatalogue::kindName(result.kind) << " " << result.minClearance << ".." << result.maxClearance << " mm";
+        if (result.kind != result.required) output << ", required " << FitCatalogue::kindName(result.required);
+        output << std::endl;
+    }
+}
+
+FitReport FitChecker::check(const std::vector<ShaftProportions>& variants) const {
+    const auto start = std::chrono::steady_clock::now();
+    FitReport report;
+    report.variantCount = variants.size();
+    const Standard_Integer variantCount = static_cast<Standard_Integer>(variants.size());
+
+    std::vector<ShaftReadout> readouts(variants.size());
+    OSD_Parallel::For(0, variantCount, [&](Standard_Integer i) {
+        readouts[i] = ShaftAnalysis::analyze(variants[i]);
+    });
+
+    // Каждый вариант занимает непрерывный участок массивов: посадочные места, затем по две проверки на паз
+    const std::vector<SeatRule>& seats = m_catalogue.getSeats();
+    std::vector<size_t> offsets(variants.size() + 1, 0);
+    for (size_t i = 0; i < variants.size(); ++i) {
+        offsets[i + 1] = offsets[i] + seats.size() + 2 * readouts[i].slotDetails.size();
+    }
+    const size_t fitCount = offsets.back();
+    report.results.resize(fitCount);
+    std::vector<double> boreLower(fitCount, 0.0), boreUpper(fitCount, 0.0);
+    std::vector<double> shaftLower(fitCount, 0.0), shaftUpper(fitCount, 0.0);
+
+    OSD_Parallel::For(0, variantCount, [&](Standard_Integer variant) {
+        const ShaftReadout& readout = readouts[variant];
+        size_t index = offsets[variant];
+        auto setLimits = [&](size_t fit, double holeSize, const ToleranceClass& holeTolerance,
+                             double shaftSize, const ToleranceClass& shaftTolerance) {
+            double lower = 0.0, upper = 0.0;
+            holeTolerance.deviations(holeSize, lower, upper);
+            boreLower[fit] = holeSize + lower;
+            boreUpper[fit] = holeSize + upper;
+            shaftTolerance.deviations(shaftSize, lower, upper);
+            shaftLower[fit] = shaftSize + lower;
+            shaftUpper[fit] = shaftSize + upper;
+        };
+
+        for (const SeatRule& seat : seats) {
+            FitResult& result = report.results[index];
+            result.variant = variant;
+            result.required = seat.required;
+            result.feature = "segment " + std::to_string(seat.segmentIndex + 1) + " " + seat.shaftTolerance.getName() + " / " + seat.boreKind;
+            const int matingIndex = seat.matingSegment < 0 ? seat.segmentIndex : seat.matingSegment;
+            try {
+                if (seat.segmentIndex < 0 || static_cast<size_t>(seat.segmentIndex) >= readout.segments.size() ||
+                    matingIndex < 0 || static_cast<size_t>(matingIndex) >= readout.segments.size()) {
+                    throw std::out_of_range("segment is missing in this layout");
+                }
+                const SegmentReadout& segment = readout.segments[seat.segmentIndex];
+                if (segment.type != "cylinder") throw std::invalid_argument("seat segment is not a cylinder");
+                const double matingDiameter = readout.segments[matingIndex].diameter;
+                const MatingBore* bore = m_catalogue.findBore(seat.boreKind, matingDiameter);
+                if (!bore) throw std::invalid_argument("no " + seat.boreKind + " for diameter " + formatSize(matingDiameter));
+                const double boreDiameter = bore->diameter > 0.0 ? bore->diameter : matingDiameter;
+                result.feature = segment.name + " " + formatSize(segment.diameter) + " " + seat.shaftTolerance.getName() +
+                                 " / " + bore->name + " " + formatSize(boreDiameter) + " " + bore->tolerance.getName();
+                setLimits(index, boreDiameter, bore->tolerance, segment.diameter, seat.shaftTolerance);
+            } catch (const std::exception& e) {
+                result.error = e.what();
+            }
+            ++index;
+        }
+
+        for (size_t slot = 0; slot < readout.slotDetails.size(); ++slot) {
+            const SlotReadout& details = readout.slotDetails[slot];
+            const KeySpec* key = m_catalogue.findKey(details.hostDiameter);
+            const std::string prefix = "slot " + std::to_string(slot + 1) + " " + formatSize(details.width) + "x" + formatSize(details.depth);
+
+            // Ширина: паз вала - охватывающий размер, шпонка - охватываемый
+            FitResult& width = report.results[index];
+            width.variant = variant;
+            width.required = m_catalogue.getKeyFit();
+            width.feature = prefix + " width " + m_catalogue.getSlotTolerance().getName();
+            // Высота: зазор между верхом шпонки и дном паза ступицы t2
+            FitResult& height = report.results[index + 1];
+            height.variant = variant;
+            height.required = FitKind::Clearance;
+            height.feature = prefix + " key top / hub slot";
+            if (!key) {
+                width.error = height.error = "no key for shaft diameter " + formatSize(details.hostDiameter);
+                index += 2;
+                continue;
+            }
+            const std::string keyName = " key " + formatSize(key->width) + "x" + formatSize(key->height);
+            width.feature += " /" + keyName + " " + m_catalogue.getKeyTolerance().getName();
+            height.feature += " t2 " + formatSize(key->hubDepth) + " /" + keyName;
+            try {
+                setLimits(index, details.width, m_catalogue.getSlotTolerance(), key->width, m_catalogue.getKeyTolerance());
+            } catch (const std::exception& e) {
+                width.error = e.what();
+            }
+            const double protrusion = key->height - details.depth;
+            if (protrusion <= 0.0) height.error = "key does not protrude into the hub";
+            boreLower[index + 1] = boreUpper[index + 1] = key->hubDepth;
+            shaftLower[index + 1] = shaftUpper[index + 1] = protrusion;
+            index += 2;
+        }
+    });
+
+    // Зазоры одним проходом по массивам; цикл без ветвлений векторизуется компилятором
+    std::vector<double> minClearance(fitCount), maxClearance(fitCount);
+    const size_t blockSize = 4096;
+    const Standard_Integer blockCount = static_cast<Standard_Integer>((fitCount + blockSize - 1) / blockSize);
+    OSD_Parallel::For(0, blockCount, [&](Standard_Integer block) {
+        const size_t begin = static_cast<size_t>(block) * blockSize;
+        const size_t end = std::min(begin + blockSize, fitCount);
+        const double* holeMin = boreLower.data();
+        const double* holeMax = boreUpper.data();
+        const double* shaftMin = shaftLower.data();
+        const double* shaftMax = shaftUpper.data();
+        double* clearanceMin = minClearance.data();
+        double* clearanceMax = maxClearance.data();
+        for (size_t i = begin; i < end; ++i) {
+            clearanceMin[i] = holeMin[i] - shaftMax[i];
+            clearanceMax[i] = holeMax[i] - shaftMin[i];
+        }
+    });
+
+    report.variantValid.assign(variants.size(), 1);
+    OSD_Parallel::For(0, variantCount, [&](Standard_Integer variant) {
+        for (size_t i = offsets[variant]; i < offsets[variant + 1]; ++i) {
+            FitResult& result = report.results[i];
+            result.minClearance = minClearance[i];
+            result.maxClearance = maxClearance[i];
+            if (minClearance[i] >= -clearanceEpsilon) result.kind = FitKind::Clearance;
+            else if (maxClearance[i] <= clearanceEpsilon) result.kind = FitKind::Interference;
+            else result.kind = FitKind::Transition;
+            if (!result.isValid()) report.variantValid[variant] = 0;
+        }
+    });
+
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return report;
+}
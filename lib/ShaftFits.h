@@ -0,0 +1,218 @@
+/**
+ * @file ShaftFits.h
+ * @brief Проверка посадок вала по ISO 286 против каталога сопрягаемых деталей
+ */
+
+#ifndef SHAFT_FITS_H
+#define SHAFT_FITS_H
+
+#include "ShaftProportions.h"
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Характер посадки по зазору между отверстием и валом
+ */
+enum class FitKind { Clearance, Transition, Interference };
+
+/**
+ * @class ToleranceClass
+ * @brief Поле допуска ISO 286 (H7, k6, JS9, ...) или явные отклонения "нижнее/верхнее" в мм
+ *
+ * Поддерживаются квалитеты IT5-IT11 для размеров до 120 мм, основные отклонения валов
+ * f, g, h, js, k, m, n, p и отверстий F, G, H, JS, K, M, N, P.
+ */
+class ToleranceClass {
+public:
+    ToleranceClass() = default;
+
+    /**
+     * @brief Разобрать обозначение поля допуска или пару отклонений "-0.01/0"
+     */
+    static ToleranceClass parse(const std::string& text);
+
+    /**
+     * @brief Предельные отклонения для номинального размера, мм
+     * @param nominal Номинальный размер, мм
+     * @param lower Нижнее отклонение
+     * @param upper Верхнее отклонение
+     */
+    void deviations(double nominal, double& lower, double& upper) const;
+
+    bool isHole() const { return m_hole; }
+    const std::string& getName() const { return m_name; }
+
+    /**
+     * @brief Допуск квалитета IT<grade> для номинального размера, мкм
+     */
+    static double standardTolerance(int grade, double nominal);
+
+private:
+    std::string m_name;      // Обозначение как в исходной строке
+    std::string m_letter;    // Основное отклонение в нижнем регистре; пусто для явных отклонений
+    int m_grade = 0;
+    bool m_hole = false;
+    double m_lower = 0.0;    // Явные отклонения, мм
+    double m_upper = 0.0;
+};
+
+/**
+ * @struct MatingBore
+ * @brief Отверстие сопрягаемой детали (подшипник, ступица)
+ */
+struct MatingBore {
+    std::string kind;          // Вид детали, на который ссылаются посадочные места
+    std::string name;
+    double diameter;           // Номинальный диаметр; 0 - деталь изготавливается под размер вала
+    ToleranceClass tolerance;
+};
+
+/**
+ * @struct KeySpec
+ * @brief Призматическая шпонка для диапазона диаметров вала (dMin, dMax]
+ */
+struct KeySpec {
+    double shaftMin;
+    double shaftMax;
+    double width;
+    double height;
+    double shaftDepth;   // Глубина паза вала t1
+    double hubDepth;     // Глубина паза ступицы t2
+};
+
+/**
+ * @struct SeatRule
+ * @brief Посадочное место: сегмент вала, его поле допуска и сопрягаемая деталь
+ *
+ * Для канавок (уменьшенных сегментов) отверстие берётся по диаметру соседнего
+ * посадочного сегмента matingSegment: деталь должна проходить над канавкой.
+ */
+struct SeatRule {
+    int segmentIndex;
+    ToleranceClass shaftTolerance;
+    std::string boreKind;
+    int matingSegment;    // Сегмент, по диаметру которого выбирается отверстие; -1 - тот же
+    FitKind required;
+};
+
+/**
+ * @class FitCatalogue
+ * @brief Каталог сопрягаемых деталей и правила посадок
+ */
+class FitCatalogue {
+public:
+    void addBore(const MatingBore& bore) { m_bores.push_back(bore); }
+    void addKey(const KeySpec& key) { m_keys.push_back(key); }
+    void addSeat(const SeatRule& seat) { m_seats.push_back(seat); }
+
+    /**
+     * @brief Задать поля допуска ширины шпонки и паза вала и требуемую посадку шпонки
+     */
+    void setKeyFit(const ToleranceClass& keyTolerance, const ToleranceClass& slotTolerance, FitKind required);
+
+    /**
+     * @brief Отверстие вида kind для номинального диаметра
+     *
+     * Сначала ищется деталь с тем же номиналом, затем деталь, изготавливаемая под размер.
+     * @return nullptr, если подходящей детали нет
+     */
+    const MatingBore* findBore(const std::string& kind, double diameter) const;
+
+    /**
+     * @brief Шпонка для диаметра вала
+     * @return nullptr, если диаметр вне каталога
+     */
+    const KeySpec* findKey(double shaftDiameter) const;
+
+    const std::vector<SeatRule>& getSeats() const { return m_seats; }
+    const ToleranceClass& getKeyTolerance() const { return m_keyTolerance; }
+    const ToleranceClass& getSlotTolerance() const { return m_slotTolerance; }
+    FitKind getKeyFit() const { return m_keyFit; }
+
+    /**
+     * @brief Каталог для стандартной схемы: подшипник на цилиндре 4 (k6), ступица H7/m6 на
+     * цилиндре 9, канавки h11 под проход деталей, шпонки ISO 773 N9/h9
+     */
+    static FitCatalogue defaultCatalogue();
+
+    /**
+     * @brief Прочитать каталог из файла
+     *
+     * Строки: `bore <вид> <имя> <диаметр|*> <допуск>`, `key <dMin> <dMax> <b> <h> <t1> <t2>`,
+     * `keyfit <допуск шпонки> <допуск паза> <посадка>`,
+     * `seat <сегмент> <допуск вала> <вид> <сегмент детали|-> <посадка>`.
+     * Пустые строки и строки, начинающиеся с '#', пропускаются.
+     */
+    static FitCatalogue load(const std::string& filename);
+
+    static const char* kindName(FitKind kind);
+    static FitKind parseKind(const std::string& name);
+
+private:
+    std::vector<MatingBore> m_bores;
+    std::vector<KeySpec> m_keys;
+    std::vector<SeatRule> m_seats;
+    ToleranceClass m_keyTolerance = ToleranceClass::parse("h9");
+    ToleranceClass m_slotTolerance = ToleranceClass::parse("N9");
+    FitKind m_keyFit = FitKind::Transition;
+};
+
+/**
+ * @struct FitResult
+ * @brief Одна проверенная посадка одного варианта
+ *
+ * Зазор положителен, натяг отрицателен. Для радиальной проверки шпонки "зазор" -
+ * расстояние от верха шпонки до дна паза ступицы.
+ */
+struct FitResult {
+    size_t variant;
+    std::string feature;
+    FitKind required = FitKind::Clearance;
+    FitKind kind = FitKind::Clearance;
+    double minClearance = 0.0;
+    double maxClearance = 0.0;
+    std::string error;    // Посадку нельзя оценить (нет детали в каталоге и т.п.)
+
+    bool isValid() const { return error.empty() && kind == required; }
+};
+
+/**
+ * @struct FitReport
+ * @brief Результаты проверки всех вариантов
+ */
+struct FitReport {
+    size_t variantCount = 0;
+    std::vector<FitResult> results;   // По вариантам, внутри варианта - по посадкам
+    std::vector<char> variantValid;
+    double seconds = 0.0;
+
+    bool isValid(size_t variant) const { return variantValid[variant] != 0; }
+    size_t validCount() const;
+
+    /**
+     * @brief Вывести посадки; при failuresOnly - только нарушения
+     * @param names Имена вариантов; пустой список - номера
+     */
+    void print(std::ostream& output, const std::vector<std::string>& names = {}, bool failuresOnly = true) const;
+};
+
+/**
+ * @class FitChecker
+ * @brief Аналитическая проверка посадок многих вариантов без построения B-rep
+ *
+ * Размеры сегментов и пазов берутся из ShaftAnalysis. Предельные размеры всех посадок
+ * раскладываются по массивам (структура массивов), после чего зазоры считаются
+ * одним проходом, разбитым на блоки по потокам.
+ */
+class FitChecker {
+public:
+    explicit FitChecker(const FitCatalogue& catalogue) : m_catalogue(catalogue) {}
+
+    FitReport check(const std::vector<ShaftProportions>& variants) const;
+
+private:
+    const FitCatalogue& m_catalogue;
+};
+
+#endif // SHAFT_FITS_H
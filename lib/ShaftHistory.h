@@ -0,0 +1,124 @@
+/**
+ * @file ShaftHistory.h
+ * @brief История снимков параметров вала с отменой, повтором и ветвлением
+ */
+
+#ifndef SHAFT_HISTORY_H
+#define SHAFT_HISTORY_H
+
+#include <TopoDS_Shape.hxx>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+#include "ShaftProportions.h"
+#include "ShaftValidator.h"
+
+/**
+ * @struct ShaftSnapshot
+ * @brief Снимок параметров вала и связанный с ним результат построения
+ */
+struct ShaftSnapshot {
+    ShaftProportions proportions;  // Параметры (разделяют неизменённые данные с соседними снимками)
+    TopoDS_Shape shape;            // Построенный вал, пустой, если снимок ещё не строился
+    int parent;                    // Индекс родительского снимка, -1 для первого
+    std::string label;             // Подпись для выбора варианта
+    std::string buildSettings;     // Настройки построителя, с которыми получен shape
+    CheckLevel checkLevel = CheckLevel::None;  // Уровень проверки, пройденный shape
+    double toleranceLimit = ShaftValidator::defaultToleranceLimit;  // Предел допусков этой проверки, мм
+};
+
+/**
+ * @class ShaftHistory
+ * @brief Дерево снимков: отмена ведёт к родителю, повтор - к последнему посещённому потомку
+ *
+ * Новый снимок после отмены начинает новую ветку, старая ветка остаётся доступной через
+ * checkout(), что позволяет сравнивать варианты. TopoDS_Shape хранит геометрию по ссылке,
+ * поэтому возврат к снимку возвращает и его построенный вал без копирования.
+ */
+class ShaftHistory {
+private:
+    std::vector<ShaftSnapshot> m_snapshots;
+    std::vector<int> m_redoChild;  // Потомок, в который ведёт повтор из каждого снимка
+    int m_current;
+
+public:
+    ShaftHistory() : m_current(-1) {}
+
+    /**
+     * @brief Добавить снимок как потомка текущего и сделать его текущим
+     * @return Индекс нового снимка
+     */
+    int commit(const ShaftProportions& proportions, const std::string& label = std::string()) {
+        const int index = static_cast<int>(m_snapshots.size());
+        m_snapshots.push_back(ShaftSnapshot{proportions, TopoDS_Shape(), m_current,
+                                            label.empty() ? "Snapshot " + std::to_string(index) : label,
+                                            std::string(), CheckLevel::None, ShaftValidator::defaultToleranceLimit});
+        m_redoChild.push_back(-1);
+        if (m_current >= 0) m_redoChild[m_current] = index;
+        m_current = index;
+        return index;
+    }
+
+    bool canUndo() const { return m_current >= 0 && m_snapshots[m_current].parent >= 0; }
+    bool canRedo() const { return m_current >= 0 && m_redoChild[m_current] >= 0; }
+
+    /**
+     * @brief Перейти к родительскому снимку
+     * @return Новый текущий снимок или nullptr, если отменять нечего
+     */
+    const ShaftSnapshot* undo() {
+        if (!canUndo()) return nullptr;
+        const int parent = m_snapshots[m_current].parent;
+        m_redoChild[parent] = m_current;
+        m_current = parent;
+        return &m_snapshots[m_current];
+    }
+
+    /**
+     * @brief Вернуться к потомку, из которого была выполнена отмена
+     * @return Новый текущий снимок или nullptr, если повторять нечего
+     */
+    const ShaftSnapshot* redo() {
+        if (!canRedo()) return nullptr;
+        m_current = m_redoChild[m_current];
+        return &m_snapshots[m_current];
+    }
+
+    /**
+     * @brief Сделать текущим произвольный снимок (переключение между вариантами)
+     */
+    const ShaftSnapshot& checkout(int index) {
+        const ShaftSnapshot& snapshot = at(index);
+        m_current = index;
+        return snapshot;
+    }
+
+    /**
+     * @brief Связать снимок с результатом его построения
+     * @param buildSettings Настройки построителя, влияющие на геометрию
+     * @param checkLevel Уровень проверки, который прошёл вал
+     * @param toleranceLimit Предел роста допусков, с которым выполнялась проверка, мм
+     */
+    void attachShape(int index, const TopoDS_Shape& shape, const std::string& buildSettings, CheckLevel checkLevel,
+                     double toleranceLimit) {
+        at(index);
+        m_snapshots[index].shape = shape;
+        m_snapshots[index].buildSettings = buildSettings;
+        m_snapshots[index].checkLevel = checkLevel;
+        m_snapshots[index].toleranceLimit = toleranceLimit;
+    }
+
+    const ShaftSnapshot& at(int index) const {
+        if (index < 0 || index >= static_cast<int>(m_snapshots.size())) {
+            throw std::out_of_range("Snapshot index out of valid range");
+        }
+        return m_snapshots[index];
+    }
+
+    const ShaftSnapshot* current() const { return m_current >= 0 ? &m_snapshots[m_current] : nullptr; }
+    int currentIndex() const { return m_current; }
+    size_t size() const { return m_snapshots.size(); }
+};
+
+#endif // SHAFT_HISTORY_H
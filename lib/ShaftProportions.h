@@ -9,6 +9,7 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <memory>
 #include <stdexcept>
 #include <iostream>
 #include <tuple>
@@ -47,79 +48,132 @@ struct SlotProportion {
         offsetFromSegmentStart(offsetFromSegmentStart), segmentIndex(segmentIndex) {}
 };
 
+/**
+ * @class ShaftProportions
+ * @brief Пропорции вала
+ *
+ * Списки сегментов, пазов и заданных диаметров хранятся как неизменяемые разделяемые
+ * данные: копия объекта разделяет их с оригиналом, а изменение заменяет только
+ * затронутый список. Поэтому снимки параметров для истории правок стоят O(изменения).
+ */
 class ShaftProportions {
 private:
-    std::vector<ShaftSegmentProportion> proportions;
+    using SegmentList = std::vector<ShaftSegmentProportion>;
+    using SlotList = std::vector<SlotProportion>;
+    using DiameterMap = std::map<int, double>;
+
+    std::shared_ptr<const SegmentList> proportions;
     double baseDiameter;
     double totalLength;
-    std::map<int, double> customDiameters;
+    std::shared_ptr<const DiameterMap> customDiameters;
     double chamferLengthRatio;
-    std::vector<SlotProportion> slotProportions;
+    std::shared_ptr<const SlotList> slotProportions;
     double totalLengthRatio;
+    bool customLayout;
+    bool verbose;  // Сообщать о пересчёте пропорций в журнал
 
 public:
-    ShaftProportions(double totalLength = 230.0, double cylinder4Diameter = 23.0, double cylinder9Diameter = 27.0)
-        : totalLength(totalLength), baseDiameter(23.0), chamferLengthRatio(0.025 / 23.0) {
+    /**
+     * @param verbose false - не выводить сообщения о пересчёте (аналитические расчёты, много вариантов)
+     */
+    ShaftProportions(double totalLength = 230.0, double cylinder4Diameter = 23.0, double cylinder9Diameter = 27.0,
+                     bool verbose = true)
+        : totalLength(totalLength), baseDiameter(23.0), chamferLengthRatio(0.025 / 23.0), customLayout(false),
+        verbose(verbose) {
         initDefaultProportions();
-        customDiameters[3] = cylinder4Diameter;
-        customDiameters[9] = cylinder9Diameter;
+        customDiameters = std::make_shared<const DiameterMap>(DiameterMap{{3, cylinder4Diameter}, {9, cylinder9Diameter}});
         recalculateProportions();
         initDefaultSlotProportions();
     }
 
     void initDefaultProportions() {
-        proportions.clear();
-        proportions.push_back(ShaftSegmentProportion("Cylinder 1", "cylinder", 18.0 / 230.0, 23.0 / 23.0));
-        proportions.push_back(ShaftSegmentProportion("Cylinder 2", "cylinder", 15.0 / 230.0, 25.0 / 23.0));
-        proportions.push_back(ShaftSegmentProportion("Cylinder 3", "cylinder", 3.0 / 230.0, 23.0 / 23.0, 0.0, true));
-        proportions.push_back(ShaftSegmentProportion("Cylinder 4", "cylinder", 27.0 / 230.0, 23.0 / 23.0));
-        proportions.push_back(ShaftSegmentProportion("Cylinder 5", "cylinder", 3.0 / 230.0, 23.0 / 23.0, 0.0, true));
-        proportions.push_back(ShaftSegmentProportion("Cylinder 6", "cylinder", 14.0 / 230.0, 35.0 / 23.0));
-        proportions.push_back(ShaftSegmentProportion("Конус", "cone", 5.0 / 230.0, 35.0 / 23.0, 40.0 / 23.0));
-        proportions.push_back(ShaftSegmentProportion("Cylinder 7", "cylinder", 40.0 / 230.0, 40.0 / 23.0));
-        proportions.push_back(ShaftSegmentProportion("Cylinder 8", "cylinder", 3.0 / 230.0, 23.0 / 23.0, 0.0, true));
-        proportions.push_back(ShaftSegmentProportion("Cylinder 9", "cylinder", 59.0 / 230.0, 27.0 / 23.0));
-        proportions.push_back(ShaftSegmentProportion("Cylinder 10", "cylinder", 3.0 / 230.0, 23.0 / 23.0));
-        proportions.push_back(ShaftSegmentProportion("Cylinder 11", "cylinder", 21.0 / 230.0, 25.0 / 23.0));
-        proportions.push_back(ShaftSegmentProportion("Cylinder 12", "cylinder", 19.0 / 230.0, 23.0 / 23.0));
+        // Стандартная схема одна на все экземпляры
+        static const std::shared_ptr<const SegmentList> defaultProportions = std::make_shared<const SegmentList>(SegmentList{
+            ShaftSegmentProportion("Cylinder 1", "cylinder", 18.0 / 230.0, 23.0 / 23.0),
+            ShaftSegmentProportion("Cylinder 2", "cylinder", 15.0 / 230.0, 25.0 / 23.0),
+            ShaftSegmentProportion("Cylinder 3", "cylinder", 3.0 / 230.0, 23.0 / 23.0, 0.0, true),
+            ShaftSegmentProportion("Cylinder 4", "cylinder", 27.0 / 230.0, 23.0 / 23.0),
+            ShaftSegmentProportion("Cylinder 5", "cylinder", 3.0 / 230.0, 23.0 / 23.0, 0.0, true),
+            ShaftSegmentProportion("Cylinder 6", "cylinder", 14.0 / 230.0, 35.0 / 23.0),
+            ShaftSegmentProportion("Конус", "cone", 5.0 / 230.0, 35.0 / 23.0, 40.0 / 23.0),
+            ShaftSegmentProportion("Cylinder 7", "cylinder", 40.0 / 230.0, 40.0 / 23.0),
+            ShaftSegmentProportion("Cylinder 8", "cylinder", 3.0 / 230.0, 23.0 / 23.0, 0.0, true),
+            ShaftSegmentProportion("Cylinder 9", "cylinder", 59.0 / 230.0, 27.0 / 23.0),
+            ShaftSegmentProportion("Cylinder 10", "cylinder", 3.0 / 230.0, 23.0 / 23.0),
+            ShaftSegmentProportion("Cylinder 11", "cylinder", 21.0 / 230.0, 25.0 / 23.0),
+            ShaftSegmentProportion("Cylinder 12", "cylinder", 19.0 / 230.0, 23.0 / 23.0)});
+        proportions = defaultProportions;
         totalLengthRatio = 1.0;
     }
 
+    /**
+     * @brief Заменить стандартную схему вала произвольным набором сегментов и пазов
+     *
+     * Доли длин сегментов задаются относительно общей длины вала. Заданные ранее
+     * диаметры отдельных сегментов относятся к стандартной схеме и сбрасываются.
+     */
+    void setLayout(const std::vector<ShaftSegmentProportion>& segments, const std::vector<SlotProportion>& slots) {
+        if (segments.empty()) throw std::invalid_argument("Shaft layout must contain at least one segment");
+        double ratioSum = 0.0;
+        for (const auto& segment : segments) {
+            if (segment.lengthRatio <= 0 || segment.diameterRatio <= 0) {
+                throw std::invalid_argument("Segment " + segment.name + " must have positive length and diameter");
+            }
+            ratioSum += segment.lengthRatio;
+        }
+        for (const auto& slot : slots) {
+            if (slot.segmentIndex < 0 || static_cast<size_t>(slot.segmentIndex) >= segments.size()) {
+                throw std::out_of_range("Slot segment index out of valid range");
+            }
+        }
+        proportions = std::make_shared<const SegmentList>(segments);
+        slotProportions = std::make_shared<const SlotList>(slots);
+        customDiameters = std::make_shared<const DiameterMap>();
+        totalLengthRatio = ratioSum;
+        customLayout = true;
+    }
+
+    bool hasCustomLayout() const { return customLayout; }
+
     void setCustomDiameter(int segmentIndex, double diameter) {
-        if (segmentIndex < 0 || segmentIndex >= proportions.size()) {
+        if (segmentIndex < 0 || segmentIndex >= proportions->size()) {
             throw std::out_of_range("Segment index out of valid range");
         }
         if (diameter <= 20.0) throw std::invalid_argument("Diameter must be a positive number");
         if (diameter > 35.0) throw std::invalid_argument("Diameter cannot exceed 50 mm");
-        customDiameters[segmentIndex] = diameter;
+        auto diameters = std::make_shared<DiameterMap>(*customDiameters);
+        (*diameters)[segmentIndex] = diameter;
+        customDiameters = diameters;
         if (segmentIndex == 3 || segmentIndex == 9) recalculateProportions();
     }
 
     void recalculateProportions() {
-        if (customDiameters.empty()) return;
-        if (customDiameters.find(3) != customDiameters.end()) {
-            double cylinder4Diameter = customDiameters[3];
+        const DiameterMap& diameters = *customDiameters;
+        const SegmentList& segments = *proportions;
+        if (diameters.empty()) return;
+        if (diameters.find(3) != diameters.end()) {
+            double cylinder4Diameter = diameters.at(3);
             if (cylinder4Diameter <= 0) {
                 std::cerr << "Error: 4th cylinder diameter cannot be zero or negative" << std::endl;
                 return;
             }
-            double newBaseDiameter = cylinder4Diameter / proportions[3].diameterRatio;
+            double newBaseDiameter = cylinder4Diameter / segments[3].diameterRatio;
             if (newBaseDiameter <= 0) {
                 std::cerr << "Error: Calculated base diameter cannot be zero or negative" << std::endl;
                 return;
             }
             double scaleFactor = newBaseDiameter / baseDiameter;
             baseDiameter = newBaseDiameter;
-            std::cout << "Recalculating proportions based on the 4th cylinder diameter: "
+            if (verbose) std::cout << "Recalculating proportions based on the 4th cylinder diameter: "
                       << "new base diameter = " << baseDiameter
                       << ", scaling factor = " << scaleFactor << std::endl;
-        } else if (customDiameters.find(9) != customDiameters.end()) {
-            double cylinder9Diameter = customDiameters[9];
+        } else if (diameters.find(9) != diameters.end()) {
+            double cylinder9Diameter = diameters.at(9);
             if (cylinder9Diameter <= 0) {
                 std::cerr << "Error: 9th cylinder diameter cannot be zero or negative" << std::endl;
                 return;
             }
-            double ratio = proportions[9].diameterRatio;
+            double ratio = segments[9].diameterRatio;
             if (ratio <= 0) {
                 std::cerr << "Error: Diameter ratio for the 9th cylinder cannot be zero or negative" << std::endl;
                 return;
@@ -131,7 +185,7 @@ public:
             }
             double scaleFactor = newBaseDiameter / baseDiameter;
             baseDiameter = newBaseDiameter;
-            std::cout << "Recalculating proportions based on the 9th cylinder diameter: "
+            if (verbose) std::cout << "Recalculating proportions based on the 9th cylinder diameter: "
                       << "new base diameter = " << baseDiameter
                       << ", scaling factor = " << scaleFactor << std::endl;
         }
@@ -139,39 +193,40 @@ public:
 
     double getChamferLength() const { return chamferLengthRatio * baseDiameter; }
 
-    size_t getSegmentCount() const { return proportions.size(); }
+    size_t getSegmentCount() const { return proportions->size(); }
 
     std::tuple<std::string, double, double, double, bool> getSegmentInfo(size_t index) const {
-        if (index >= proportions.size()) throw std::out_of_range("Segment index out of valid range");
-        const auto& prop = proportions[index];
+        if (index >= proportions->size()) throw std::out_of_range("Segment index out of valid range");
+        const auto& prop = (*proportions)[index];
         double length = prop.lengthRatio * totalLength;
-        double diameter = customDiameters.find(index) != customDiameters.end() ? customDiameters.at(index) : prop.diameterRatio * baseDiameter;
+        double diameter = customDiameters->find(index) != customDiameters->end() ? customDiameters->at(index) : prop.diameterRatio * baseDiameter;
         double diameterEnd = prop.type == "cone" ? prop.diameterEndRatio * baseDiameter : 0.0;
         return std::make_tuple(prop.type, length, diameter, diameterEnd, prop.needsReduction);
     }
 
     std::string getSegmentName(size_t index) const {
-        if (index >= proportions.size()) throw std::out_of_range("Segment index out of valid range");
-        return proportions[index].name;
+        if (index >= proportions->size()) throw std::out_of_range("Segment index out of valid range");
+        return (*proportions)[index].name;
     }
 
     double getSegmentDiameter(size_t index) const {
-        if (index >= proportions.size()) throw std::out_of_range("Segment index out of valid range");
-        const auto& prop = proportions[index];
-        return customDiameters.find(index) != customDiameters.end() ? customDiameters.at(index) : prop.diameterRatio * baseDiameter;
+        if (index >= proportions->size()) throw std::out_of_range("Segment index out of valid range");
+        const auto& prop = (*proportions)[index];
+        return customDiameters->find(index) != customDiameters->end() ? customDiameters->at(index) : prop.diameterRatio * baseDiameter;
     }
 
     void initDefaultSlotProportions() {
-        slotProportions.clear();
-        slotProportions.push_back(SlotProportion(8.0, 5.0, 10.0, 8.5, 3));
-        slotProportions.push_back(SlotProportion(8.0, 4.0, 22.0, 8.0, 9));
+        static const std::shared_ptr<const SlotList> defaultSlots = std::make_shared<const SlotList>(SlotList{
+            SlotProportion(8.0, 5.0, 10.0, 8.5, 3),
+            SlotProportion(8.0, 4.0, 22.0, 8.0, 9)});
+        slotProportions = defaultSlots;
     }
 
-    size_t getSlotCount() const { return slotProportions.size(); }
+    size_t getSlotCount() const { return slotProportions->size(); }
 
     std::tuple<double, double, double, double, int> getSlotInfo(size_t index) const {
-        if (index >= slotProportions.size()) throw std::out_of_range("Slot index out of valid range");
-        const auto& slot = slotProportions[index];
+        if (index >= slotProportions->size()) throw std::out_of_range("Slot index out of valid range");
+        const auto& slot = (*slotProportions)[index];
         double offset = slot.offsetFromSegmentStart;
         double scaledWidth = slot.width * (baseDiameter / 23.0);
         double scaledDepth = slot.depth * (baseDiameter / 23.0);
@@ -185,10 +240,49 @@ public:
         if (length <= 20) throw std::invalid_argument("Total shaft length must be positive");
         if (length > 300.0) throw std::invalid_argument("Total shaft length cannot exceed 300 mm");
         totalLength = length;
-        initDefaultSlotProportions();
+        if (!customLayout) initDefaultSlotProportions();
     }
 
     double getBaseDiameter() const { return baseDiameter; }
+
+    /**
+     * @brief Проверить, что два набора пропорций совпадают
+     *
+     * Разделяемые списки сравниваются по указателю, поэтому для снимков одной
+     * истории проверка не обходит содержимое.
+     */
+    bool sameAs(const ShaftProportions& other) const {
+        return baseDiameter == other.baseDiameter && totalLength == other.totalLength &&
+               chamferLengthRatio == other.chamferLengthRatio &&
+               (customDiameters == other.customDiameters || *customDiameters == *other.customDiameters) &&
+               sameSegments(other) && sameSlots(other);
+    }
+
+private:
+    bool sameSegments(const ShaftProportions& other) const {
+        if (proportions == other.proportions) return true;
+        if (proportions->size() != other.proportions->size()) return false;
+        for (size_t i = 0; i < proportions->size(); ++i) {
+            const auto& a = (*proportions)[i];
+            const auto& b = (*other.proportions)[i];
+            if (a.name != b.name || a.type != b.type || a.lengthRatio != b.lengthRatio ||
+                a.diameterRatio != b.diameterRatio || a.diameterEndRatio != b.diameterEndRatio ||
+                a.needsReduction != b.needsReduction) return false;
+        }
+        return true;
+    }
+
+    bool sameSlots(const ShaftProportions& other) const {
+        if (slotProportions == other.slotProportions) return true;
+        if (slotProportions->size() != other.slotProportions->size()) return false;
+        for (size_t i = 0; i < slotProportions->size(); ++i) {
+            const auto& a = (*slotProportions)[i];
+            const auto& b = (*other.slotProportions)[i];
+            if (a.width != b.width || a.depth != b.depth || a.length != b.length ||
+                a.offsetFromSegmentStart != b.offsetFromSegmentStart || a.segmentIndex != b.segmentIndex) return false;
+        }
+        return true;
+    }
 };
 
 #endif // SHAFT_PROPORTIONS_H
@@ -0,0 +1,168 @@
+#include "ShaftSignature.h"
+#include <BRepAdaptor_Surface.hxx>
+#include <BRepBndLib.hxx>
+#include <BRepGProp.hxx>
+#include <Bnd_Box.hxx>
+#include <GProp_GProps.hxx>
+#include <TopExp.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+#include <TopoDS.hxx>
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+
+const double planeTolerance = 1e-6;
+
+int countShapes(const TopoDS_Shape& shape, TopAbs_ShapeEnum type) {
+    TopTools_IndexedMapOfShape shapes;
+    TopExp::MapShapes(shape, type, shapes);
+    return shapes.Extent();
+}
+
+void tightBox(const TopoDS_Shape& shape, double box[6]) {
+    Bnd_Box bounds;
+    BRepBndLib::AddOptimal(shape, bounds, Standard_False, Standard_False);
+    if (bounds.IsVoid()) return;
+    bounds.Get(box[0], box[1], box[2], box[3], box[4], box[5]);
+}
+
+bool differs(double value, double golden, double tolerance) {
+    return std::fabs(value - golden) > tolerance;
+}
+
+std::string describe(const std::string& name, double value, double golden) {
+    std::ostringstream text;
+    text.precision(10);
+    text << name << ' ' << value << " (golden " << golden << ")";
+    return text.str();
+}
+
+} // namespace
+
+ShaftSignature ShaftSignature::measure(const TopoDS_Shape& shape) {
+    ShaftSignature signature;
+    GProp_GProps volumeProps;
+    BRepGProp::VolumeProperties(shape, volumeProps);
+    signature.volume = volumeProps.Mass();
+    GProp_GProps surfaceProps;
+    BRepGProp::SurfaceProperties(shape, surfaceProps);
+    signature.area = surfaceProps.Mass();
+    tightBox(shape, signature.box);
+    signature.solids = countShapes(shape, TopAbs_SOLID);
+    signature.faces = countShapes(shape, TopAbs_FACE);
+    signature.edges = countShapes(shape, TopAbs_EDGE);
+    signature.vertices = countShapes(shape, TopAbs_VERTEX);
+
+    const double zMin = signature.box[2];
+    const double zMax = signature.box[5];
+    std::vector<SlotFloorSignature> floors;
+    TopTools_IndexedMapOfShape faces;
+    TopExp::MapShapes(shape, TopAbs_FACE, faces);
+    for (Standard_Integer i = 1; i <= faces.Extent(); ++i) {
+        const TopoDS_Face& face = TopoDS::Face(faces(i));
+        BRepAdaptor_Surface surface(face);
+        double faceBox[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+        if (surface.GetType() == GeomAbs_Plane) {
+            gp_Pln plane = surface.Plane();
+            if (std::fabs(std::fabs(plane.Axis().Direction().Y()) - 1.0) > planeTolerance) continue;
+            tightBox(face, faceBox);
+            floors.push_back(SlotFloorSignature{plane.Location().Y(), faceBox[2], faceBox[5]});
+        } else if (surface.GetType() == GeomAbs_Cone) {
+            tightBox(face, faceBox);
+            // Конический сегмент вала не касается торцов, фаски - касаются
+            if (faceBox[2] - zMin < planeTolerance) signature.chamferStart = faceBox[5] - faceBox[2];
+            if (zMax - faceBox[5] < planeTolerance) signature.chamferEnd = faceBox[5] - faceBox[2];
+        }
+    }
+
+    // Части одного дна лежат в одной плоскости и примыкают друг к другу по Z
+    std::sort(floors.begin(), floors.end(), [](const SlotFloorSignature& a, const SlotFloorSignature& b) {
+        if (std::fabs(a.y - b.y) > planeTolerance) return a.y < b.y;
+        return a.zMin < b.zMin;
+    });
+    for (const SlotFloorSignature& floor : floors) {
+        if (!signature.slotFloors.empty()) {
+            SlotFloorSignature& last = signature.slotFloors.back();
+            if (std::fabs(last.y - floor.y) <= planeTolerance && floor.zMin <= last.zMax + planeTolerance) {
+                last.zMax = std::max(last.zMax, floor.zMax);
+                continue;
+            }
+        }
+        signature.slotFloors.push_back(floor);
+    }
+    std::sort(signature.slotFloors.begin(), signature.slotFloors.end(),
+              [](const SlotFloorSignature& a, const SlotFloorSignature& b) { return a.zMin < b.zMin; });
+    return signature;
+}
+
+std::vector<std::string> ShaftSignature::compare(const ShaftSignature& golden,
+                                                 const SignatureTolerances& tolerances) const {
+    std::vector<std::string> differences;
+    if (differs(volume, golden.volume, tolerances.relative * std::fabs(golden.volume))) {
+        differences.push_back(describe("volume", volume, golden.volume));
+    }
+    if (differs(area, golden.area, tolerances.relative * std::fabs(golden.area))) {
+        differences.push_back(describe("area", area, golden.area));
+    }
+    static const char* boxNames[6] = {"xmin", "ymin", "zmin", "xmax", "ymax", "zmax"};
+    for (int i = 0; i < 6; ++i) {
+        if (differs(box[i], golden.box[i], tolerances.length)) {
+            differences.push_back(describe(boxNames[i], box[i], golden.box[i]));
+        }
+    }
+    if (solids != golden.solids) differences.push_back(describe("solids", solids, golden.solids));
+    if (faces != golden.faces || edges != golden.edges) {
+        differences.push_back(describe("faces", faces, golden.faces));
+        differences.push_back(describe("edges", edges, golden.edges));
+    }
+    if (differs(chamferStart, golden.chamferStart, tolerances.length)) {
+        differences.push_back(describe("start chamfer", chamferStart, golden.chamferStart));
+    }
+    if (differs(chamferEnd, golden.chamferEnd, tolerances.length)) {
+        differences.push_back(describe("end chamfer", chamferEnd, golden.chamferEnd));
+    }
+    if (slotFloors.size() != golden.slotFloors.size()) {
+        differences.push_back(describe("slot floors", static_cast<double>(slotFloors.size()),
+                                       static_cast<double>(golden.slotFloors.size())));
+    } else {
+        for (size_t i = 0; i < slotFloors.size(); ++i) {
+            const SlotFloorSignature& a = slotFloors[i];
+            const SlotFloorSignature& b = golden.slotFloors[i];
+            std::string name = "slot " + std::to_string(i);
+            if (differs(a.y, b.y, tolerances.length)) differences.push_back(describe(name + " floor y", a.y, b.y));
+            if (differs(a.zMin, b.zMin, tolerances.length)) differences.push_back(describe(name + " zmin", a.zMin, b.zMin));
+            if (differs(a.zMax, b.zMax, tolerances.length)) differences.push_back(describe(name + " zmax", a.zMax, b.zMax));
+        }
+    }
+    return differences;
+}
+
+void ShaftSignature::write(std::ostream& output) const {
+    std::ostringstream line;
+    line << std::setprecision(12) << volume << ' ' << area;
+    for (double value : box) line << ' ' << value;
+    line << ' ' << solids << ' ' << faces << ' ' << edges << ' ' << vertices
+         << ' ' << chamferStart << ' ' << chamferEnd << ' ' << slotFloors.size();
+    for (const SlotFloorSignature& floor : slotFloors) {
+        line << ' ' << floor.y << ' ' << floor.zMin << ' ' << floor.zMax;
+    }
+    output << line.str();
+}
+
+bool ShaftSignature::read(std::istream& input) {
+    size_t floorCount = 0;
+    if (!(input >> volume >> area)) return false;
+    for (double& value : box) {
+        if (!(input >> value)) return false;
+    }
+    if (!(input >> solids >> faces >> edges >> vertices >> chamferStart >> chamferEnd >> floorCount)) return false;
+    slotFloors.assign(floorCount, SlotFloorSignature{0.0, 0.0, 0.0});
+    for (SlotFloorSignature& floor : slotFloors) {
+        if (!(input >> floor.y >> floor.zMin >> floor.zMax)) return false;
+    }
+    return true;
+}
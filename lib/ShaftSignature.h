@@ -0,0 +1,79 @@
+/**
+ * @file ShaftSignature.h
+ * @brief Компактная геометрическая сигнатура вала для сравнения результатов построения
+ */
+
+#ifndef SHAFT_SIGNATURE_H
+#define SHAFT_SIGNATURE_H
+
+#include <TopoDS_Shape.hxx>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @struct SlotFloorSignature
+ * @brief Дно паза: плоскость Y = y, занимающая по оси вала участок [zMin, zMax]
+ */
+struct SlotFloorSignature {
+    double y;
+    double zMin;
+    double zMax;
+};
+
+/**
+ * @struct SignatureTolerances
+ * @brief Допуски сравнения сигнатур
+ *
+ * Числа тел, граней и рёбер всегда должны совпадать с эталоном точно.
+ */
+struct SignatureTolerances {
+    double relative = 1e-5;   // Относительный допуск объёма и площади
+    double length = 1e-4;     // Допуск линейных размеров, мм
+};
+
+/**
+ * @struct ShaftSignature
+ * @brief Интегральные свойства, габариты, топология, положение пазов и размеры торцевых фасок
+ */
+struct ShaftSignature {
+    double volume = 0.0;
+    double area = 0.0;
+    double box[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};  // xmin, ymin, zmin, xmax, ymax, zmax
+    int solids = 0;
+    int faces = 0;
+    int edges = 0;
+    int vertices = 0;
+    double chamferStart = 0.0;  // Длина фаски на торце Z = zmin вдоль оси, 0 если фаски нет
+    double chamferEnd = 0.0;    // Длина фаски на торце Z = zmax
+    std::vector<SlotFloorSignature> slotFloors;  // По возрастанию zMin
+
+    /**
+     * @brief Измерить сигнатуру построенного вала
+     *
+     * Днища пазов ищутся как плоские грани с нормалью вдоль Y; соседние грани одной
+     * плоскости объединяются, поэтому результат не зависит от того, на сколько граней
+     * разбито дно. Фаски - конические грани, касающиеся торцов.
+     */
+    static ShaftSignature measure(const TopoDS_Shape& shape);
+
+    /**
+     * @brief Сравнить с эталоном
+     * @return Описания расхождений, пусто при совпадении
+     */
+    std::vector<std::string> compare(const ShaftSignature& golden, const SignatureTolerances& tolerances) const;
+
+    /**
+     * @brief Записать в одну строку текста
+     */
+    void write(std::ostream& output) const;
+
+    /**
+     * @brief Прочитать строку, записанную write()
+     * @return false при ошибке формата
+     */
+    bool read(std::istream& input);
+};
+
+#endif // SHAFT_SIGNATURE_H
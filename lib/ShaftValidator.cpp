@@ -0,0 +1,195 @@
+#include "ShaftValidator.h"
+#include <BRepCheck.hxx>
+#include <BRepCheck_Analyzer.hxx>
+#include <BRepCheck_ListOfStatus.hxx>
+#include <BRepCheck_Result.hxx>
+#include <BOPAlgo_ArgumentAnalyzer.hxx>
+#include <BRep_Tool.hxx>
+#include <OSD_Parallel.hxx>
+#include <Standard_Failure.hxx>
+#include <TopExp.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+#include <TopoDS.hxx>
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+/**
+ * @brief Добавить к тексту статусы BRepCheck подформы, отличные от NoError
+ */
+void appendStatuses(const BRepCheck_Analyzer& analyzer, const TopoDS_Shape& shape, std::ostringstream& text) {
+    Handle(BRepCheck_Result) result = analyzer.Result(shape);
+    if (result.IsNull()) return;
+    for (BRepCheck_ListIteratorOfListOfStatus it(result->Status()); it.More(); it.Next()) {
+        if (it.Value() == BRepCheck_NoError) continue;
+        text << ' ';
+        BRepCheck::Print(it.Value(), text);
+    }
+}
+
+} // namespace
+
+void ValidationReport::print(std::ostream& output) const {
+    output << "Validation (" << ShaftValidator::levelName(level) << ", " << faceCount << " faces, max tolerance "
+           << maxTolerance << " mm): " << (isValid() ? "valid" : std::to_string(issues.size()) + " issue(s)")
+           << " in " << seconds << " s" << std::endl;
+    for (const auto& timing : timings) {
+        output << "  " << timing.first << ": " << timing.second << " s" << std::endl;
+    }
+    for (const ValidationIssue& issue : issues) {
+        output << "  [" << issue.check << "] ";
+        if (issue.faceIndex >= 0) output << "face " << issue.faceIndex << ": ";
+        output << issue.message << std::endl;
+    }
+}
+
+const char* ShaftValidator::levelName(CheckLevel level) {
+    switch (level) {
+    case CheckLevel::Fast: return "fast";
+    case CheckLevel::Standard: return "standard";
+    case CheckLevel::Full: return "full";
+    default: return "none";
+    }
+}
+
+CheckLevel ShaftValidator::parseLevel(const std::string& name) {
+    if (name == "none") return CheckLevel::None;
+    if (name == "fast") return CheckLevel::Fast;
+    if (name == "standard") return CheckLevel::Standard;
+    if (name == "full") return CheckLevel::Full;
+    throw std::invalid_argument("unknown check level " + name);
+}
+
+ValidationReport ShaftValidator::check(const TopoDS_Shape& shape) const {
+    ValidationReport report;
+    report.level = m_level;
+    if (m_level == CheckLevel::None) return report;
+    const Clock::time_point start = Clock::now();
+    if (shape.IsNull()) {
+        report.issues.push_back(ValidationIssue{"shape", "shape is empty", -1});
+        return report;
+    }
+
+    // Каждый этап перехватывает сбои OCCT сам, чтобы отказ анализатора не скрыл результаты остальных
+    auto stage = [&](const char* name, void (ShaftValidator::*method)(const TopoDS_Shape&, ValidationReport&) const) {
+        const Clock::time_point stageStart = Clock::now();
+        try {
+            (this->*method)(shape, report);
+        } catch (const Standard_Failure& e) {
+            report.issues.push_back(ValidationIssue{name, std::string("analyzer failed: ") + e.GetMessageString(), -1});
+        }
+        report.timings.emplace_back(name, secondsSince(stageStart));
+    };
+    stage("closedness", &ShaftValidator::checkClosedness);
+    stage("tolerance", &ShaftValidator::checkTolerances);
+    if (m_level >= CheckLevel::Standard) stage("faces", &ShaftValidator::checkFaces);
+    if (m_level >= CheckLevel::Full) stage("self-intersection", &ShaftValidator::checkSelfIntersection);
+
+    report.seconds = secondsSince(start);
+    return report;
+}
+
+void ShaftValidator::checkClosedness(const TopoDS_Shape& shape, ValidationReport& report) const {
+    int solidCount = 0;
+    for (TopExp_Explorer it(shape, TopAbs_SOLID); it.More(); it.Next()) ++solidCount;
+    if (solidCount == 0) {
+        report.issues.push_back(ValidationIssue{"closedness", "shape contains no solid", -1});
+    } else if (solidCount > 1) {
+        report.issues.push_back(ValidationIssue{"closedness",
+            "shape falls apart into " + std::to_string(solidCount) + " solids", -1});
+    }
+    int shellIndex = 0;
+    for (TopExp_Explorer it(shape, TopAbs_SHELL); it.More(); it.Next()) {
+        ++shellIndex;
+        if (!BRep_Tool::IsClosed(it.Current())) {
+            report.issues.push_back(ValidationIssue{"closedness",
+                "shell " + std::to_string(shellIndex) + " has free edges", -1});
+        }
+    }
+}
+
+void ShaftValidator::checkTolerances(const TopoDS_Shape& shape, ValidationReport& report) const {
+    struct Counter { const char* name; TopAbs_ShapeEnum type; int exceeded; double worst; };
+    Counter counters[] = {{"faces", TopAbs_FACE, 0, 0.0}, {"edges", TopAbs_EDGE, 0, 0.0},
+                          {"vertices", TopAbs_VERTEX, 0, 0.0}};
+    for (Counter& counter : counters) {
+        TopTools_IndexedMapOfShape elements;
+        TopExp::MapShapes(shape, counter.type, elements);
+        if (counter.type == TopAbs_FACE) report.faceCount = elements.Extent();
+        for (Standard_Integer i = 1; i <= elements.Extent(); ++i) {
+            double tolerance = 0.0;
+            if (counter.type == TopAbs_FACE) tolerance = BRep_Tool::Tolerance(TopoDS::Face(elements(i)));
+            else if (counter.type == TopAbs_EDGE) tolerance = BRep_Tool::Tolerance(TopoDS::Edge(elements(i)));
+            else tolerance = BRep_Tool::Tolerance(TopoDS::Vertex(elements(i)));
+            counter.worst = std::max(counter.worst, tolerance);
+            if (tolerance > m_toleranceLimit) ++counter.exceeded;
+        }
+        report.maxTolerance = std::max(report.maxTolerance, counter.worst);
+        if (counter.exceeded > 0) {
+            std::ostringstream text;
+            text << counter.exceeded << ' ' << counter.name << " exceed tolerance " << m_toleranceLimit
+                 << " mm (worst " << counter.worst << " mm)";
+            report.issues.push_back(ValidationIssue{"tolerance", text.str(), -1});
+        }
+    }
+}
+
+void ShaftValidator::checkFaces(const TopoDS_Shape& shape, ValidationReport& report) const {
+    TopTools_IndexedMapOfShape faces;
+    TopExp::MapShapes(shape, TopAbs_FACE, faces);
+    report.faceCount = faces.Extent();
+
+    // Грани независимы, поэтому каждая проверяется своим анализатором в параллельном цикле
+    std::vector<std::string> messages(faces.Extent());
+    OSD_Parallel::For(0, faces.Extent(), [&](Standard_Integer i) {
+        const TopoDS_Shape& face = faces(i + 1);
+        try {
+            BRepCheck_Analyzer analyzer(face, Standard_True);
+            if (analyzer.IsValid()) return;
+            std::ostringstream text;
+            appendStatuses(analyzer, face, text);
+            TopTools_IndexedMapOfShape subShapes;
+            TopExp::MapShapes(face, TopAbs_WIRE, subShapes);
+            TopExp::MapShapes(face, TopAbs_EDGE, subShapes);
+            TopExp::MapShapes(face, TopAbs_VERTEX, subShapes);
+            for (Standard_Integer k = 1; k <= subShapes.Extent(); ++k) appendStatuses(analyzer, subShapes(k), text);
+            messages[i] = "invalid:" + (text.str().empty() ? std::string(" BRepCheck failed") : text.str());
+        } catch (const Standard_Failure& e) {
+            messages[i] = std::string("analyzer failed: ") + e.GetMessageString();
+        }
+    });
+    for (size_t i = 0; i < messages.size(); ++i) {
+        if (!messages[i].empty()) {
+            report.issues.push_back(ValidationIssue{"faces", messages[i], static_cast<int>(i) + 1});
+        }
+    }
+}
+
+void ShaftValidator::checkSelfIntersection(const TopoDS_Shape& shape, ValidationReport& report) const {
+    BOPAlgo_ArgumentAnalyzer analyzer;
+    analyzer.SetShape1(shape);
+    analyzer.ArgumentTypeMode() = Standard_False;
+    analyzer.SelfInterMode() = Standard_True;
+    analyzer.SmallEdgeMode() = Standard_False;
+    analyzer.SetRunParallel(Standard_True);
+    analyzer.Perform();
+    if (!analyzer.HasFaulty()) return;
+
+    int selfIntersections = 0;
+    for (BOPAlgo_ListIteratorOfListOfCheckResult it(analyzer.GetCheckResult()); it.More(); it.Next()) {
+        if (it.Value().GetCheckStatus() == BOPAlgo_SelfIntersect) ++selfIntersections;
+    }
+    report.issues.push_back(ValidationIssue{"self-intersection", selfIntersections > 0
+        ? std::to_string(selfIntersections) + " self-intersecting sub-shape pair(s)"
+        : std::string("argument analyzer reported faulty geometry"), -1});
+}
@@ -0,0 +1,94 @@
+/**
+ * @file ShaftValidator.h
+ * @brief Проверка геометрической корректности построенного вала
+ */
+
+#ifndef SHAFT_VALIDATOR_H
+#define SHAFT_VALIDATOR_H
+
+#include <TopoDS_Shape.hxx>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Уровень проверки: каждый следующий включает проверки предыдущего
+ *
+ * Fast - замкнутость оболочек и рост допусков (для пакетного режима),
+ * Standard - дополнительно анализ каждой грани BRepCheck параллельно,
+ * Full - дополнительно поиск самопересечений.
+ */
+enum class CheckLevel { None, Fast, Standard, Full };
+
+/**
+ * @struct ValidationIssue
+ * @brief Найденная проблема геометрии
+ */
+struct ValidationIssue {
+    std::string check;    // Название проверки
+    std::string message;  // Описание проблемы
+    int faceIndex;        // Номер грани (с 1) или -1, если проблема относится ко всему телу
+};
+
+/**
+ * @struct ValidationReport
+ * @brief Результат проверки с затраченным временем по этапам
+ */
+struct ValidationReport {
+    CheckLevel level = CheckLevel::None;
+    int faceCount = 0;
+    double maxTolerance = 0.0;
+    double seconds = 0.0;
+    std::vector<std::pair<std::string, double>> timings;  // Этап и время, с
+    std::vector<ValidationIssue> issues;
+
+    bool isValid() const { return issues.empty(); }
+
+    /**
+     * @brief Вывести найденные проблемы и время этапов
+     */
+    void print(std::ostream& output) const;
+};
+
+/**
+ * @class ShaftValidator
+ * @brief Проверка тела вала анализаторами OCCT с выбором стоимости через CheckLevel
+ */
+class ShaftValidator {
+public:
+    /**
+     * @brief Допуск по умолчанию: булевы операции и фаски обычно дают допуски рёбер
+     * 1e-5..5e-4 мм, поэтому нарушением считается рост выше 1 мкм
+     */
+    static constexpr double defaultToleranceLimit = 1e-3;
+
+    /**
+     * @param level Уровень проверки
+     * @param toleranceLimit Допуск, превышение которого считается ростом допусков, мм
+     */
+    explicit ShaftValidator(CheckLevel level = CheckLevel::Standard, double toleranceLimit = defaultToleranceLimit)
+        : m_level(level), m_toleranceLimit(toleranceLimit) {}
+
+    ValidationReport check(const TopoDS_Shape& shape) const;
+
+    CheckLevel getLevel() const { return m_level; }
+
+    static const char* levelName(CheckLevel level);
+
+    /**
+     * @brief Разобрать имя уровня (none, fast, standard, full)
+     */
+    static CheckLevel parseLevel(const std::string& name);
+
+private:
+    void checkClosedness(const TopoDS_Shape& shape, ValidationReport& report) const;
+    void checkTolerances(const TopoDS_Shape& shape, ValidationReport& report) const;
+    void checkFaces(const TopoDS_Shape& shape, ValidationReport& report) const;
+    void checkSelfIntersection(const TopoDS_Shape& shape, ValidationReport& report) const;
+
+    CheckLevel m_level;
+    double m_toleranceLimit;
+};
+
+#endif // SHAFT_VALIDATOR_H
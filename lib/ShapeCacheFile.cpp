@@ -0,0 +1,202 @@
+#include "ShapeCacheFile.h"
+#include <BRepTools.hxx>
+#include <BRep_Builder.hxx>
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace {
+
+const char* const recordTag = "shaft-cache";
+
+/**
+ * @brief Найти начало следующей записи после повреждённой
+ *
+ * Тег ищется и не в начале строки: прерванная запись могла оставить хвост без перевода строки.
+ * @return Смещение заголовка или -1, если записей дальше нет
+ */
+long long nextRecord(std::ifstream& input, long long from) {
+    const std::string marker = std::string(recordTag) + ' ';
+    const size_t chunkSize = 1 << 16;
+    std::string window;
+    long long windowStart = from;
+    input.clear();
+    input.seekg(from);
+    std::string chunk(chunkSize, '\0');
+    while (input.read(&chunk[0], chunkSize) || input.gcount() > 0) {
+        window.append(chunk, 0, static_cast<size_t>(input.gcount()));
+        size_t found = window.find(marker);
+        if (found != std::string::npos) return windowStart + static_cast<long long>(found);
+        // Хвост окна может содержать начало маркера, разрезанного границей блока
+        const size_t keep = std::min(window.size(), marker.size() - 1);
+        windowStart += static_cast<long long>(window.size() - keep);
+        window.erase(0, window.size() - keep);
+    }
+    return -1;
+}
+
+/**
+ * @brief Дописать запись одним вызовом записи под исключительной блокировкой файла
+ * @param recordStart Смещение начала записи в файле
+ */
+bool appendRecord(const std::string& filename, const std::string& record, long long& recordStart) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filename.c_str(), FILE_APPEND_DATA | FILE_READ_ATTRIBUTES,
+                              FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    OVERLAPPED whole = {};
+    bool success = false;
+    if (LockFileEx(file, LOCKFILE_EXCLUSIVE_LOCK, 0, MAXDWORD, MAXDWORD, &whole)) {
+        LARGE_INTEGER size;
+        DWORD written = 0;
+        if (GetFileSizeEx(file, &size) &&
+            WriteFile(file, record.data(), static_cast<DWORD>(record.size()), &written, nullptr) &&
+            written == record.size()) {
+            recordStart = size.QuadPart;
+            success = true;
+        }
+        UnlockFileEx(file, 0, MAXDWORD, MAXDWORD, &whole);
+    }
+    CloseHandle(file);
+    return success;
+#else
+    int fd = ::open(filename.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) return false;
+    bool success = false;
+    if (::flock(fd, LOCK_EX) == 0) {
+        const off_t start = ::lseek(fd, 0, SEEK_END);
+        ssize_t written;
+        do {
+            written = ::write(fd, record.data(), record.size());
+        } while (written < 0 && errno == EINTR);
+        if (start >= 0 && written == static_cast<ssize_t>(record.size())) {
+            recordStart = static_cast<long long>(start);
+            success = true;
+        } else if (start >= 0 && written > 0) {
+            // Неполная запись (нет места на диске) отрезается, чтобы не повредить файл
+            if (::ftruncate(fd, start) != 0) {
+                std::cerr << "Warning: cannot remove a partial record from " << filename << std::endl;
+            }
+        }
+        ::flock(fd, LOCK_UN);
+    }
+    ::close(fd);
+    return success;
+#endif
+}
+
+} // namespace
+
+void ShapeCacheFile::index() {
+    m_indexed = true;
+    m_entries.clear();
+    std::ifstream input(m_filename, std::ios::binary);
+    if (!input) return;
+    input.seekg(0, std::ios::end);
+    const long long fileSize = static_cast<long long>(input.tellg());
+
+    // Повреждённая запись пропускается до следующего заголовка, остальные записи сохраняются
+    int damaged = 0;
+    long long position = 0;
+    std::string header;
+    while (position >= 0 && position < fileSize) {
+        input.clear();
+        input.seekg(position);
+        if (!std::getline(input, header)) break;
+        std::istringstream fields(header);
+        std::string tag;
+        long long keySize = 0;
+        long long dataSize = 0;
+        const long long keyStart = static_cast<long long>(input.tellg());
+        if (!(fields >> tag >> keySize >> dataSize) || tag != recordTag || keySize < 0 || dataSize < 0 ||
+            keyStart < 0 || keyStart + keySize + dataSize > fileSize) {
+            // Недописанная последняя запись повреждением не считается
+            const long long next = nextRecord(input, position + 1);
+            if (next >= 0 || tag != recordTag) ++damaged;
+            position = next;
+            continue;
+        }
+        // Уровень и предел проверки появились позже; старые записи читаются как непроверенные
+        CheckLevel checkLevel = CheckLevel::None;
+        double toleranceLimit = std::numeric_limits<double>::infinity();
+        std::string levelName;
+        if (fields >> levelName) {
+            try {
+                checkLevel = ShaftValidator::parseLevel(levelName);
+            } catch (const std::exception&) {
+                checkLevel = CheckLevel::None;
+            }
+            if (!(fields >> toleranceLimit) || !(toleranceLimit > 0.0)) {
+                toleranceLimit = std::numeric_limits<double>::infinity();
+            }
+        }
+        std::string key(static_cast<size_t>(keySize), '\0');
+        if (!input.read(&key[0], keySize)) break;
+        // Более поздняя запись с тем же ключом заменяет раннюю
+        m_entries[key] = Entry{keyStart + keySize, dataSize, checkLevel, toleranceLimit};
+        position = keyStart + keySize + dataSize;
+    }
+    if (damaged > 0) {
+        std::cerr << "Warning: shape cache " << m_filename << " has " << damaged
+                  << " damaged record(s), skipped" << std::endl;
+    }
+}
+
+bool ShapeCacheFile::find(const std::string& key, TopoDS_Shape& shape, CheckLevel& checkLevel,
+                          double& toleranceLimit) {
+    if (!m_indexed) index();
+    auto found = m_entries.find(key);
+    if (found == m_entries.end()) return false;
+
+    std::ifstream input(m_filename, std::ios::binary);
+    input.seekg(found->second.offset);
+    std::string data(static_cast<size_t>(found->second.size), '\0');
+    if (!input || !input.read(&data[0], found->second.size)) return false;
+    std::istringstream stream(data);
+    BRep_Builder builder;
+    shape.Nullify();
+    BRepTools::Read(shape, stream, builder);
+    checkLevel = found->second.checkLevel;
+    toleranceLimit = found->second.toleranceLimit;
+    return !shape.IsNull();
+}
+
+bool ShapeCacheFile::store(const std::string& key, const TopoDS_Shape& shape, CheckLevel checkLevel,
+                           double toleranceLimit) {
+    if (!m_indexed) index();
+    std::ostringstream data;
+    BRepTools::Write(shape, data);
+    const std::string payload = data.str();
+
+    // Запись собирается целиком и дописывается одним вызовом под блокировкой, поэтому
+    // параллельные процессы с тем же снимком не перемежают свои записи
+    std::ostringstream record;
+    record << std::setprecision(std::numeric_limits<double>::max_digits10);
+    record << recordTag << ' ' << key.size() << ' ' << payload.size() << ' '
+           << ShaftValidator::levelName(checkLevel) << ' ' << toleranceLimit << '\n' << key;
+    const long long prefixSize = static_cast<long long>(record.tellp());
+    record << payload;
+    long long recordStart = 0;
+    if (!appendRecord(m_filename, record.str(), recordStart)) {
+        std::cerr << "Warning: cannot write shape cache " << m_filename << std::endl;
+        return false;
+    }
+    m_entries[key] = Entry{recordStart + prefixSize, static_cast<long long>(payload.size()), checkLevel,
+                           toleranceLimit};
+    return true;
+}
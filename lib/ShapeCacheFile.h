@@ -0,0 +1,66 @@
+/**
+ * @file ShapeCacheFile.h
+ * @brief Файл-снимок построенных валов для быстрого повторного запуска
+ */
+
+#ifndef SHAPE_CACHE_FILE_H
+#define SHAPE_CACHE_FILE_H
+
+#include "ShaftValidator.h"
+#include <TopoDS_Shape.hxx>
+#include <map>
+#include <string>
+
+/**
+ * @class ShapeCacheFile
+ * @brief Валы в формате BRep, записанные по каноническому ключу
+ *
+ * Запись файла: строка "shaft-cache <размер ключа> <размер данных> <уровень проверки> <предел
+ * допусков>", ключ и данные BRep. Уровень - пройденная валом проверка (none, fast, standard, full),
+ * предел - допуск этой проверки в мм; в записях без уровня вал считается непроверенным.
+ * При открытии читаются только заголовки и ключи, данные пропускаются, поэтому
+ * размер снимка почти не влияет на время запуска. BRep разбирается только для
+ * найденного ключа. Запись дописывается одним вызовом под блокировкой файла, поэтому
+ * снимок можно разделять между процессами; повреждённые записи пропускаются при чтении.
+ */
+class ShapeCacheFile {
+public:
+    explicit ShapeCacheFile(const std::string& filename) : m_filename(filename), m_indexed(false) {}
+
+    /**
+     * @brief Найти вал по ключу
+     * @param checkLevel Уровень проверки, пройденный валом при записи
+     * @param toleranceLimit Предел допусков этой проверки, мм
+     * @return true, если вал найден и прочитан
+     */
+    bool find(const std::string& key, TopoDS_Shape& shape, CheckLevel& checkLevel, double& toleranceLimit);
+
+    /**
+     * @brief Дописать вал в конец снимка
+     * @param checkLevel Уровень проверки, пройденный валом
+     * @param toleranceLimit Предел допусков этой проверки, мм
+     * @return true при успехе
+     */
+    bool store(const std::string& key, const TopoDS_Shape& shape, CheckLevel checkLevel, double toleranceLimit);
+
+    const std::string& getFilename() const { return m_filename; }
+
+private:
+    /**
+     * @brief Прочитать заголовки записей и запомнить смещения данных
+     */
+    void index();
+
+    struct Entry {
+        long long offset;  // Смещение данных BRep от начала файла
+        long long size;    // Размер данных, байт
+        CheckLevel checkLevel;
+        double toleranceLimit;
+    };
+
+    std::string m_filename;
+    std::map<std::string, Entry> m_entries;
+    bool m_indexed;
+};
+
+#endif // SHAPE_CACHE_FILE_H
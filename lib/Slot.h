@@ -3,14 +3,12 @@
 
 #include <string>
 #include <TopoDS_Shape.hxx>
-#include <gp_Pnt.hxx>
-#include <gp_Ax2.hxx>
-#include <gp_Dir.hxx>
-#include <BRepPrimAPI_MakeBox.hxx>
-#include <BRepPrimAPI_MakeCylinder.hxx>
-#include <BRepAlgoAPI_Fuse.hxx>
+#include <TopLoc_Location.hxx>
+#include <gp_Trsf.hxx>
+#include <gp_Vec.hxx>
 #include <stdexcept>
-#include <iostream>
+
+#include "SlotToolCache.h"
 
 
 /**
@@ -24,46 +22,58 @@ private:
     Standard_Real length;     // Длина паза
     Standard_Real zStart;     // Начальная координата Z паза
     Standard_Real yOffset;    // Смещение по Y от центра вала
+    SlotForm form;            // Форма паза
+    Standard_Real cutterRadius; // Радиус дисковой фрезы
 
 public:
     Slot(Standard_Real width, Standard_Real depth, Standard_Real length,
-         Standard_Real zStart, Standard_Real cylinderRadius)
-        : width(width), depth(depth), length(length), zStart(zStart) {
+         Standard_Real zStart, Standard_Real cylinderRadius,
+         SlotForm form = SlotForm::EndMilled, Standard_Real cutterRadius = 0.0)
+        : width(width), depth(depth), length(length), zStart(zStart), form(form), cutterRadius(cutterRadius) {
         if (depth > cylinderRadius) {
             throw std::invalid_argument("Глубина паза (" + std::to_string(depth) +
                                         ") превышает радиус цилиндра (" + std::to_string(cylinderRadius) + ")");
         }
+        if (form == SlotForm::DiscMilled && cutterRadius < depth) {
+            throw std::invalid_argument("Радиус дисковой фрезы (" + std::to_string(cutterRadius) +
+                                        ") меньше глубины паза (" + std::to_string(depth) + ")");
+        }
         yOffset = cylinderRadius - depth;
-        std::cout << "Паз создан: радиус цилиндра=" << cylinderRadius << ", yOffset=" << yOffset << std::endl;
     }
 
+    /**
+     * @brief Инструмент паза: общая для одинаковых пазов призма из кэша, перенесённая на место паза
+     */
     TopoDS_Shape create() const {
-        Standard_Real radiusSemi = width / 2.0;
-
-        // Создаем прямоугольную часть паза
-        gp_Pnt originRect(-width / 2.0, yOffset, zStart);
-        TopoDS_Shape rect = BRepPrimAPI_MakeBox(originRect, width, depth, length).Shape();
-
-        // Создаем левую полуокружность
-        gp_Ax2 axisLeft(gp_Pnt(0.0, yOffset, zStart), gp_Dir(0.0, 1.0, 0.0));
-        TopoDS_Shape circleLeft = BRepPrimAPI_MakeCylinder(axisLeft, radiusSemi, depth).Shape();
+        TopoDS_Shape tool = SlotToolCache::instance().tool(form, width, depth, length, cutterRadius);
+        gp_Trsf placement;
+        placement.SetTranslation(gp_Vec(0.0, yOffset, zStart));
+        return tool.Moved(TopLoc_Location(placement));
+    }
 
-        // Создаем правую полуокружность
-        gp_Ax2 axisRight(gp_Pnt(0.0, yOffset, zStart + length), gp_Dir(0.0, 1.0, 0.0));
-        TopoDS_Shape circleRight = BRepPrimAPI_MakeCylinder(axisRight, radiusSemi, depth).Shape();
+    // Геттеры
+    Standard_Real getZStart() const { return zStart; }
+    Standard_Real getLength() const { return length; }
+    Standard_Real getWidth() const { return width; }
+    Standard_Real getDepth() const { return depth; }
+    SlotForm getForm() const { return form; }
 
-        // Объединяем части паза
-        BRepAlgoAPI_Fuse fuse1(rect, circleLeft);
-        if (!fuse1.IsDone()) {
-            throw std::runtime_error("Error fusing slot with left circle");
-        }
+    /**
+     * @brief Минимальная координата Z инструмента паза с учётом скругления
+     */
+    Standard_Real getZMin() const { return zStart - endExtent(); }
 
-        BRepAlgoAPI_Fuse fuse2(fuse1.Shape(), circleRight);
-        if (!fuse2.IsDone()) {
-            throw std::runtime_error("Error fusing slot with right circle");
-        }
+    /**
+     * @brief Максимальная координата Z инструмента паза с учётом скругления
+     */
+    Standard_Real getZMax() const { return zStart + length + endExtent(); }
 
-        return fuse2.Shape();
+private:
+    /**
+     * @brief Вынос конца инструмента за прямой участок
+     */
+    Standard_Real endExtent() const {
+        return form == SlotForm::DiscMilled ? SlotToolCache::discRunout(depth, cutterRadius) : width / 2.0;
     }
 };
 
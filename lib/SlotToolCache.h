@@ -0,0 +1,150 @@
+/**
+ * @file SlotToolCache.h
+ * @brief Построение и кэширование инструментов пазов в виде одной призмы
+ */
+
+#ifndef SLOT_TOOL_CACHE_H
+#define SLOT_TOOL_CACHE_H
+
+#include <TopoDS_Shape.hxx>
+#include <TopoDS_Edge.hxx>
+#include <TopoDS_Wire.hxx>
+#include <TopoDS_Face.hxx>
+#include <gp_Pnt.hxx>
+#include <gp_Vec.hxx>
+#include <GC_MakeArcOfCircle.hxx>
+#include <GC_MakeSegment.hxx>
+#include <BRepBuilderAPI_MakeEdge.hxx>
+#include <BRepBuilderAPI_MakeWire.hxx>
+#include <BRepBuilderAPI_MakeFace.hxx>
+#include <BRepPrimAPI_MakePrism.hxx>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <tuple>
+
+/**
+ * @brief Форма паза
+ *
+ * EndMilled - шпоночный паз концевой фрезой: скруглённые в плане концы радиусом width/2.
+ * DiscMilled - паз дисковой фрезой: концы выходят на поверхность по дуге радиуса фрезы.
+ */
+enum class SlotForm { EndMilled, DiscMilled };
+
+/**
+ * @class SlotToolCache
+ * @brief Кэш инструментов пазов, построенных в начале координат
+ *
+ * Инструмент строится вытягиванием плоского профиля без булевых операций: дно паза лежит
+ * в плоскости Y = 0, прямой участок начинается в Z = 0. Вызывающий размещает инструмент
+ * переносом, поэтому одинаковые пазы разных валов разделяют одну геометрию.
+ * Доступ защищён мьютексом: пазы сегментов вырезаются параллельно. Общий инструмент
+ * используется в вырезах только в неразрушающем режиме (ShaftBuilder::cutTools).
+ */
+class SlotToolCache {
+public:
+    static SlotToolCache& instance() {
+        static SlotToolCache cache;
+        return cache;
+    }
+
+    /**
+     * @brief Получить инструмент паза, построив его при первом обращении
+     * @param cutterRadius Радиус дисковой фрезы (только для SlotForm::DiscMilled)
+     */
+    TopoDS_Shape tool(SlotForm form, Standard_Real width, Standard_Real depth, Standard_Real length,
+                      Standard_Real cutterRadius = 0.0) {
+        const Key key(form, quantize(width), quantize(depth), quantize(length),
+                      form == SlotForm::DiscMilled ? quantize(cutterRadius) : 0);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto found = m_tools.find(key);
+        if (found != m_tools.end()) return found->second;
+        // Размер кэша ограничен: рабочие процессы пакетов живут долго и видят много вариантов
+        if (m_tools.size() >= maxTools) m_tools.clear();
+        TopoDS_Shape shape = form == SlotForm::DiscMilled
+            ? makeDiscMilled(width, depth, length, cutterRadius)
+            : makeEndMilled(width, depth, length);
+        m_tools.emplace(key, shape);
+        return shape;
+    }
+
+    size_t size() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_tools.size();
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tools.clear();
+    }
+
+    /**
+     * @brief Вынос концов паза дисковой фрезой за прямой участок на поверхности вала
+     */
+    static Standard_Real discRunout(Standard_Real depth, Standard_Real cutterRadius) {
+        return std::sqrt(cutterRadius * cutterRadius - (cutterRadius - depth) * (cutterRadius - depth));
+    }
+
+private:
+    using Key = std::tuple<SlotForm, long long, long long, long long, long long>;
+    static constexpr size_t maxTools = 256;
+
+    SlotToolCache() = default;
+
+    static long long quantize(Standard_Real value) { return std::llround(value * 1e6); }
+
+    static TopoDS_Edge arc(const gp_Pnt& start, const gp_Pnt& middle, const gp_Pnt& end) {
+        return BRepBuilderAPI_MakeEdge(GC_MakeArcOfCircle(start, middle, end).Value()).Edge();
+    }
+
+    static TopoDS_Edge segment(const gp_Pnt& start, const gp_Pnt& end) {
+        return BRepBuilderAPI_MakeEdge(GC_MakeSegment(start, end).Value()).Edge();
+    }
+
+    static TopoDS_Shape extrude(const TopoDS_Wire& profile, const gp_Vec& direction) {
+        BRepBuilderAPI_MakeFace face(profile, Standard_True);
+        if (!face.IsDone()) throw std::runtime_error("Error building slot profile face");
+        BRepPrimAPI_MakePrism prism(face.Face(), direction);
+        if (!prism.IsDone()) throw std::runtime_error("Error extruding slot profile");
+        return prism.Shape();
+    }
+
+    /**
+     * @brief Профиль-"стадион" в плоскости XZ, вытянутый по Y на глубину паза
+     */
+    static TopoDS_Shape makeEndMilled(Standard_Real width, Standard_Real depth, Standard_Real length) {
+        const Standard_Real r = width / 2.0;
+        BRepBuilderAPI_MakeWire wire;
+        wire.Add(segment(gp_Pnt(r, 0.0, 0.0), gp_Pnt(r, 0.0, length)));
+        wire.Add(arc(gp_Pnt(r, 0.0, length), gp_Pnt(0.0, 0.0, length + r), gp_Pnt(-r, 0.0, length)));
+        wire.Add(segment(gp_Pnt(-r, 0.0, length), gp_Pnt(-r, 0.0, 0.0)));
+        wire.Add(arc(gp_Pnt(-r, 0.0, 0.0), gp_Pnt(0.0, 0.0, -r), gp_Pnt(r, 0.0, 0.0)));
+        if (!wire.IsDone()) throw std::runtime_error("Error building end-milled slot profile");
+        return extrude(wire.Wire(), gp_Vec(0.0, depth, 0.0));
+    }
+
+    /**
+     * @brief Профиль в плоскости YZ с концами по дуге фрезы, вытянутый по X на ширину паза
+     */
+    static TopoDS_Shape makeDiscMilled(Standard_Real width, Standard_Real depth, Standard_Real length,
+                                       Standard_Real cutterRadius) {
+        if (cutterRadius < depth) throw std::invalid_argument("Cutter radius is smaller than the slot depth");
+        const Standard_Real x = -width / 2.0;
+        const Standard_Real runout = discRunout(depth, cutterRadius);
+        const Standard_Real middleRunout = discRunout(depth / 2.0, cutterRadius);
+        BRepBuilderAPI_MakeWire wire;
+        wire.Add(segment(gp_Pnt(x, 0.0, 0.0), gp_Pnt(x, 0.0, length)));
+        wire.Add(arc(gp_Pnt(x, 0.0, length), gp_Pnt(x, depth / 2.0, length + middleRunout),
+                     gp_Pnt(x, depth, length + runout)));
+        wire.Add(segment(gp_Pnt(x, depth, length + runout), gp_Pnt(x, depth, -runout)));
+        wire.Add(arc(gp_Pnt(x, depth, -runout), gp_Pnt(x, depth / 2.0, -middleRunout), gp_Pnt(x, 0.0, 0.0)));
+        if (!wire.IsDone()) throw std::runtime_error("Error building disc-milled slot profile");
+        return extrude(wire.Wire(), gp_Vec(width, 0.0, 0.0));
+    }
+
+    std::mutex m_mutex;
+    std::map<Key, TopoDS_Shape> m_tools;
+};
+
+#endif // SLOT_TOOL_CACHE_H